@@ -0,0 +1,111 @@
+#include "core/parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+int parallel_worker_count() {
+  unsigned n = std::thread::hardware_concurrency();
+  return n > 0 ? (int)n : 1;
+}
+
+namespace {
+
+// One parallel_for call. Lives on the caller's stack; helpers only touch it
+// while it is queued or while they hold a share of `active`.
+struct ParallelJob {
+  const std::function<void(int)> *fn = nullptr;
+  int count = 0;
+  std::atomic<int> next{0};
+  int active = 0; // helpers inside the job, guarded by WorkerPool::mtx_
+
+  void work() {
+    for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+      (*fn)(i);
+  }
+  bool exhausted() const { return next.load() >= count; }
+};
+
+// Helper threads shared by every parallel_for, created on first use and
+// joined at exit. The calling thread always works on its own job, so a
+// parallel_for issued from inside another one finishes even when every
+// helper is busy.
+class WorkerPool {
+public:
+  explicit WorkerPool(int num_helpers) {
+    for (int i = 0; i < num_helpers; ++i)
+      threads_.emplace_back([this] { worker_loop(); });
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &t : threads_)
+      t.join();
+  }
+
+  void run(ParallelJob &job) {
+    {
+      std::lock_guard<std::mutex> lk(mtx_);
+      jobs_.push_back(&job);
+    }
+    cv_.notify_all();
+    job.work();
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), &job);
+    if (it != jobs_.end())
+      jobs_.erase(it);
+    done_cv_.wait(lk, [&] { return job.active == 0; });
+  }
+
+private:
+  void worker_loop() {
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (true) {
+      cv_.wait(lk, [this] { return stop_ || !jobs_.empty(); });
+      if (stop_) return;
+      ParallelJob *job = jobs_.front();
+      if (job->exhausted()) {
+        jobs_.pop_front();
+        continue;
+      }
+      ++job->active;
+      lk.unlock();
+      job->work();
+      lk.lock();
+      if (--job->active == 0)
+        done_cv_.notify_all();
+    }
+  }
+
+  std::deque<ParallelJob *> jobs_;
+  std::mutex                mtx_;
+  std::condition_variable   cv_;      // jobs queued or stopping
+  std::condition_variable   done_cv_; // a job lost its last helper
+  bool                      stop_ = false;
+  std::vector<std::thread>  threads_;
+};
+
+} // namespace
+
+void parallel_for(int count, const std::function<void(int)> &fn) {
+  if (count <= 0) return;
+
+  if (count == 1 || parallel_worker_count() <= 1) {
+    for (int i = 0; i < count; ++i) fn(i);
+    return;
+  }
+
+  static WorkerPool pool(parallel_worker_count() - 1);
+  ParallelJob job;
+  job.fn = &fn;
+  job.count = count;
+  pool.run(job);
+}
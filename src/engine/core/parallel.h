@@ -0,0 +1,13 @@
+#pragma once
+#include <functional>
+
+// Number of threads parallel_for will use (hardware concurrency, at least 1).
+int parallel_worker_count();
+
+// Runs fn(i) for every i in [0, count) on the calling thread plus a shared
+// pool of parallel_worker_count() - 1 helpers (started on first use), and
+// blocks until all calls have returned. Calls may nest; they share the same
+// helpers. Indices are handed out dynamically, so callers that need
+// deterministic output should write into per-index slots and merge them in
+// index order afterwards.
+void parallel_for(int count, const std::function<void(int)> &fn);
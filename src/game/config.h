@@ -28,6 +28,20 @@ struct Config {
   static constexpr float MAP_WIDTH_UNITS  = MAP_COLS / HEX_SIZE;
   static constexpr float MAP_HEIGHT_UNITS = MAP_ROWS / HEX_SIZE;
   static constexpr float LAVA_GRID_SPACING = 10.0f;
+  // Interior lava quadtree leaves span up to 2^LAVA_QUAD_MAX_LEVEL grid cells.
+  static constexpr int LAVA_QUAD_MAX_LEVEL = 4;
+  // Lava glow reaches this many world units from the nearest lava pixel.
+  static constexpr float LAVA_GLOW_RADIUS = 40.0f;
+  static constexpr float LAVA_GLOW_INTENSITY = 3.0f;
+  // Default cap on clustered lava point lights (terrain.frag reads <= 128).
+  static constexpr int LAVA_LIGHT_BUDGET = 64;
+  // Largest column edge drop GpuHexInstance can hold (hex_column.vert.glsl
+  // has the same constant).
+  static constexpr float HEX_DROP_RANGE = 2.0f;
+  // Most the lava flow sim raises the lava surface (LavaFlowSim::depth_at
+  // clamps to it). Lava tile bounds and the compact vertex position box
+  // leave this much headroom above the generated lava.
+  static constexpr float LAVA_FLOW_MAX_RISE = 0.5f;
   static constexpr float HEIGHT_THRESHOLD = 0.02f;
   static constexpr int MIN_PLATEAU_SIZE = 50;
 
@@ -46,4 +60,12 @@ struct Config {
   static constexpr uint32_t BACKGROUND_COLOR = 0xFF000000;
   static constexpr uint32_t LAVA_COLOR = 0xFFFF8C00;
   static constexpr float DEFAULT_CONTOUR_OPACITY = 0.35f;
+  static constexpr float DEFAULT_CONTOUR_TOLERANCE = 0.5f;
+  // Contour LOD pyramid: level i is simplified at tolerance * 2^i and is
+  // drawn while zoom < CONTOUR_LOD_FULL_ZOOM / 2^(i-1).
+  static constexpr int   CONTOUR_LOD_LEVELS = 4;
+  static constexpr float CONTOUR_LOD_FULL_ZOOM = 2.0f;
+  // Side of the world-space tiles lava and contour geometry is bucketed
+  // into for view culling (64 px).
+  static constexpr float GEOMETRY_TILE_UNITS = 8.0f;
 };
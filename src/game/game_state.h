@@ -33,6 +33,17 @@ struct TerrainState {
   int   current_palette = 0;
   float map_scale       = Config::DEFAULT_MAP_SCALE;
   float contour_opacity = Config::DEFAULT_CONTOUR_OPACITY;
+  float contour_tolerance = Config::DEFAULT_CONTOUR_TOLERANCE;
+  // Light lava with clustered point lights instead of the baked glow field.
+  bool  lava_point_lights = false;
+  int   lava_light_budget = Config::LAVA_LIGHT_BUDGET;
+  // Draw basalt columns as instances of one hex prism instead of baked
+  // per-column vertices.
+  bool  instanced_columns = true;
+  // Upload terrain geometry in the compact Packed* vertex formats.
+  bool  compact_vertices = false;
+  // Run the lava flow sim and raise the lava surface by its depth.
+  bool  lava_flow = false;
   bool  need_regenerate = true;
 };
 
@@ -54,4 +65,5 @@ struct ContourData {
   std::vector<float> heightmap;
   std::vector<int> band_map;
   std::vector<Line> contour_lines;
+  std::vector<ContourPolylines> polyline_lods; // [0] = finest
 };
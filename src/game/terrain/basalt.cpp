@@ -6,9 +6,8 @@
 #include "terrain/util.h"
 #include <SDL3/SDL.h>
 #include <algorithm>
+#include <climits>
 #include <cmath>
-#include <queue>
-#include <unordered_map>
 #include <vector>
 
 
@@ -58,6 +57,100 @@ static bool hex_fits_in_plateau(int q, int r, float hex_size,
   return false;
 }
 
+// Paints every pixel inside hex (q, r) as TERRAIN_BASALT. Corners are computed
+// once per hex rather than once per candidate pixel.
+static void stamp_hex_footprint(int q, int r, float hex_size,
+                                std::vector<int16_t> &terrain_map, int width,
+                                int height) {
+  Vec2 corners[6];
+  get_hex_corners(q, r, hex_size, corners);
+  float fmin_x = 1e9f, fmax_x = -1e9f, fmin_y = 1e9f, fmax_y = -1e9f;
+  for (int i = 0; i < 6; ++i) {
+    fmin_x = std::min(fmin_x, corners[i].x);
+    fmax_x = std::max(fmax_x, corners[i].x);
+    fmin_y = std::min(fmin_y, corners[i].y);
+    fmax_y = std::max(fmax_y, corners[i].y);
+  }
+  int x0 = std::max(0, (int)fmin_x - 1);
+  int x1 = std::min(width - 1, (int)fmax_x + 1);
+  int y0 = std::max(0, (int)fmin_y - 1);
+  int y1 = std::min(height - 1, (int)fmax_y + 1);
+  for (int ry = y0; ry <= y1; ++ry) {
+    for (int rx = x0; rx <= x1; ++rx) {
+      if (pixel_in_hex((float)rx, (float)ry, corners))
+        terrain_map[ry * width + rx] = TERRAIN_BASALT;
+    }
+  }
+}
+
+// Axial-space rectangle addressed as a dense array, so per-hex state can live in
+// flat vectors / bitsets instead of hash maps keyed by HexCoord.
+struct HexRect {
+  int q_min = 0, r_min = 0;
+  int q_count = 0, r_count = 0;
+
+  bool contains(int q, int r) const {
+    return q >= q_min && q < q_min + q_count && r >= r_min &&
+           r < r_min + r_count;
+  }
+  int index(int q, int r) const {
+    return (q - q_min) * r_count + (r - r_min);
+  }
+  int size() const { return q_count * r_count; }
+};
+
+static HexRect hex_rect_covering(float x0, float y0, float x1, float y1,
+                                 float hex_size, int margin) {
+  HexCoord c0 = pixel_to_hex(x0, y0, hex_size);
+  HexCoord c1 = pixel_to_hex(x1, y0, hex_size);
+  HexCoord c2 = pixel_to_hex(x0, y1, hex_size);
+  HexCoord c3 = pixel_to_hex(x1, y1, hex_size);
+
+  HexRect rect;
+  rect.q_min = std::min({c0.q, c1.q, c2.q, c3.q}) - margin;
+  rect.r_min = std::min({c0.r, c1.r, c2.r, c3.r}) - margin;
+  rect.q_count = std::max({c0.q, c1.q, c2.q, c3.q}) + margin - rect.q_min + 1;
+  rect.r_count = std::max({c0.r, c1.r, c2.r, c3.r}) + margin - rect.r_min + 1;
+  return rect;
+}
+
+// Marks a hex whose 3x3 centre probe touches more than one plateau; those fall
+// back to probing terrain_map directly.
+constexpr int16_t HEX_PROBE_MIXED = INT16_MIN;
+
+// Precomputes, for every hex covering the map, which plateau its 3x3 centre
+// probe lands in (0 = none). Same sampling as hex_fits_in_plateau.
+static std::vector<int16_t>
+build_hex_plateau_lookup(const HexRect &rect, float hex_size,
+                         std::span<const int16_t> terrain_map, int width,
+                         int height) {
+  std::vector<int16_t> lookup(rect.size(), 0);
+
+  for (int qi = 0; qi < rect.q_count; ++qi) {
+    for (int ri = 0; ri < rect.r_count; ++ri) {
+      float cx, cy;
+      hex_to_pixel(rect.q_min + qi, rect.r_min + ri, hex_size, cx, cy);
+
+      int16_t id = 0;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          int px = (int)cx + dx;
+          int py = (int)cy + dy;
+          if (px < 0 || px >= width || py < 0 || py >= height)
+            continue;
+          int16_t v = terrain_map[py * width + px];
+          if (v <= 0 || v == id)
+            continue;
+          id = (id == 0) ? v : HEX_PROBE_MIXED;
+        }
+      }
+      lookup[qi * rect.r_count + ri] = id;
+    }
+  }
+
+  return lookup;
+}
+
 std::vector<HexColumn>
 generate_basalt_columns(std::span<const float> heightmap, int width, int height,
                         float hex_size,
@@ -70,6 +163,34 @@ generate_basalt_columns(std::span<const float> heightmap, int width, int height,
 
   plateaus_with_columns_out.clear();
 
+  // Placing a column paints its footprint TERRAIN_BASALT, which is the only
+  // thing that changes a later probe result; the footprint never reaches a
+  // neighbouring hex's probe, so tracking claimed hexes keeps the lookup exact.
+  const HexRect map_rect = hex_rect_covering(0.0f, 0.0f, (float)width,
+                                             (float)height, hex_size, 2);
+  const std::vector<int16_t> centre_plateau =
+      build_hex_plateau_lookup(map_rect, hex_size, terrain_map, width, height);
+  std::vector<bool> claimed(map_rect.size(), false);
+
+  auto fits = [&](int q, int r, int16_t plateau_id) {
+    if (!map_rect.contains(q, r))
+      return false;
+    int i = map_rect.index(q, r);
+    if (claimed[i])
+      return false;
+    int16_t id = centre_plateau[i];
+    if (id == HEX_PROBE_MIXED)
+      return hex_fits_in_plateau(q, r, hex_size, terrain_map, plateau_id,
+                                 width, height);
+    return id == plateau_id;
+  };
+
+  std::vector<bool> seen;
+  std::vector<HexCoord> to_check;
+
+  const int neighbors[6][2] = {{1, 0},  {0, 1},  {-1, 1},
+                               {-1, 0}, {0, -1}, {1, -1}};
+
   for (size_t p = 0; p < plateaus.size(); ++p) {
     const auto &plateau = plateaus[p];
     int16_t plateau_id = (int16_t)(p + 1);
@@ -93,72 +214,51 @@ generate_basalt_columns(std::span<const float> heightmap, int width, int height,
     HexCoord center =
         pixel_to_hex(plateau.center_x, plateau.center_y, hex_size);
 
-    float cx, cy;
-    hex_to_pixel(center.q, center.r, hex_size, cx, cy);
-
-    bool fits = hex_fits_in_plateau(center.q, center.r, hex_size, terrain_map,
-                                    plateau_id, width, height);
-
-    if (!fits) {
+    if (!fits(center.q, center.r, plateau_id)) {
       continue;
     }
 
     int columns_before = columns.size();
 
-    std::unordered_map<HexCoord, bool, HexHash> placed;
-    std::queue<HexCoord> to_check;
-    to_check.push(center);
-    placed[center] = false;
-
-    const int neighbors[6][2] = {{1, 0},  {0, 1},  {-1, 1},
-                                 {-1, 0}, {0, -1}, {1, -1}};
+    // Any hex that can fit lies inside the plateau's pixel bbox (plus probe
+    // radius), so the flood never needs to look outside this rectangle.
+    const HexRect rect =
+        hex_rect_covering(plateau.min_x - 2.0f, plateau.min_y - 2.0f,
+                          plateau.max_x + 2.0f, plateau.max_y + 2.0f,
+                          hex_size, 2);
+    seen.assign(rect.size(), false);
+    to_check.clear();
+
+    if (rect.contains(center.q, center.r)) {
+      to_check.push_back(center);
+      seen[rect.index(center.q, center.r)] = true;
+    }
 
-    while (!to_check.empty()) {
-      HexCoord hc = to_check.front();
-      to_check.pop();
+    for (size_t head = 0; head < to_check.size(); ++head) {
+      HexCoord hc = to_check[head];
 
-      if (placed[hc])
+      if (!fits(hc.q, hc.r, plateau_id))
         continue;
 
-      if (hex_fits_in_plateau(hc.q, hc.r, hex_size, terrain_map,
-                              plateau_id, width, height)) {
-        placed[hc] = true;
+      claimed[map_rect.index(hc.q, hc.r)] = true;
 
-        uint32_t h = hash2d(hc.q, hc.r);
-        float variation = ((h & 0xFF) / 255.0f - 0.5f) * 0.05f;
+      uint32_t h = hash2d(hc.q, hc.r);
+      float variation = ((h & 0xFF) / 255.0f - 0.5f) * 0.05f;
 
-        columns.push_back(
-            {hc.q, hc.r, plateau.height + variation, plateau.height});
+      columns.push_back(
+          {hc.q, hc.r, plateau.height + variation, plateau.height});
 
-        Vec2 corners[6];
-        get_hex_corners(hc.q, hc.r, hex_size, corners);
-        float fmin_x = 1e9f, fmax_x = -1e9f, fmin_y = 1e9f, fmax_y = -1e9f;
-        for (int i = 0; i < 6; ++i) {
-          fmin_x = std::min(fmin_x, corners[i].x);
-          fmax_x = std::max(fmax_x, corners[i].x);
-          fmin_y = std::min(fmin_y, corners[i].y);
-          fmax_y = std::max(fmax_y, corners[i].y);
-        }
-        int x0 = std::max(0, (int)fmin_x - 1);
-        int x1 = std::min(width - 1, (int)fmax_x + 1);
-        int y0 = std::max(0, (int)fmin_y - 1);
-        int y1 = std::min(height - 1, (int)fmax_y + 1);
-        for (int ry = y0; ry <= y1; ++ry) {
-          for (int rx = x0; rx <= x1; ++rx) {
-            if (pixel_in_hex((float)rx, (float)ry, hc.q, hc.r, hex_size))
-              terrain_map[ry * width + rx] = TERRAIN_BASALT;
-          }
-        }
+      stamp_hex_footprint(hc.q, hc.r, hex_size, terrain_map, width, height);
 
-        for (auto [dq, dr] : neighbors) {
-          HexCoord neighbor = {hc.q + dq, hc.r + dr};
-          if (placed.find(neighbor) == placed.end()) {
-            to_check.push(neighbor);
-            placed[neighbor] = false;
-          }
+      for (auto [dq, dr] : neighbors) {
+        int nq = hc.q + dq, nr = hc.r + dr;
+        if (!rect.contains(nq, nr))
+          continue;
+        int ni = rect.index(nq, nr);
+        if (!seen[ni]) {
+          seen[ni] = true;
+          to_check.push_back({nq, nr});
         }
-      } else {
-        placed[hc] = true;
       }
     }
 
@@ -243,25 +343,7 @@ generate_basalt_columns_v2(MapData &data, float hex_size,
       columns.push_back({q, r, h, base_h});
 
 
-      Vec2 corners[6];
-      get_hex_corners(q, r, hex_size, corners);
-      float fmin_x = 1e9f, fmax_x = -1e9f, fmin_y = 1e9f, fmax_y = -1e9f;
-      for (int i = 0; i < 6; ++i) {
-        fmin_x = std::min(fmin_x, corners[i].x);
-        fmax_x = std::max(fmax_x, corners[i].x);
-        fmin_y = std::min(fmin_y, corners[i].y);
-        fmax_y = std::max(fmax_y, corners[i].y);
-      }
-      int x0 = std::max(0, (int)fmin_x - 1);
-      int x1 = std::min(width - 1, (int)fmax_x + 1);
-      int y0 = std::max(0, (int)fmin_y - 1);
-      int y1 = std::min(height - 1, (int)fmax_y + 1);
-      for (int ry = y0; ry <= y1; ++ry) {
-        for (int rx = x0; rx <= x1; ++rx) {
-          if (pixel_in_hex((float)rx, (float)ry, q, r, hex_size))
-            data.terrain_map[ry * width + rx] = TERRAIN_BASALT;
-        }
-      }
+      stamp_hex_footprint(q, r, hex_size, data.terrain_map, width, height);
     }
   }
 
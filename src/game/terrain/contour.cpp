@@ -1,8 +1,73 @@
 #include "terrain/contour.h"
+#include "core/parallel.h"
 #include <SDL3/SDL.h>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <queue>
+#include <unordered_map>
+
+// Marching-squares segments for one cell at one level. Caller guarantees the
+// cell straddles the level (some corner below, some at or above).
+//
+// Every edge is interpolated from its top/left corner, the same way the
+// neighbouring cell sharing that edge does, so crossing points are
+// bit-identical on both sides and segments can be stitched by exact match.
+static void emit_cell_segments(float level, float h00, float h10, float h01,
+                               float h11, float fx, float fy,
+                               std::vector<Line> &out) {
+  float points[4][2];
+  int point_count = 0;
+
+  if ((h00 < level && h10 >= level) || (h00 >= level && h10 < level)) {
+    float t = (level - h00) / (h10 - h00);
+    points[point_count][0] = fx + t;
+    points[point_count][1] = fy;
+    point_count++;
+  }
+
+  if ((h10 < level && h11 >= level) || (h10 >= level && h11 < level)) {
+    float t = (level - h10) / (h11 - h10);
+    points[point_count][0] = fx + 1;
+    points[point_count][1] = fy + t;
+    point_count++;
+  }
+
+  if ((h11 < level && h01 >= level) || (h11 >= level && h01 < level)) {
+    float t = (level - h01) / (h11 - h01);
+    points[point_count][0] = fx + t;
+    points[point_count][1] = fy + 1;
+    point_count++;
+  }
+
+  if ((h01 < level && h00 >= level) || (h01 >= level && h00 < level)) {
+    float t = (level - h00) / (h01 - h00);
+    points[point_count][0] = fx;
+    points[point_count][1] = fy + t;
+    point_count++;
+  }
+
+  if (point_count == 2) {
+    out.push_back(
+        {points[0][0], points[0][1], points[1][0], points[1][1], level});
+  } else if (point_count == 4) {
+    float center = (h00 + h10 + h11 + h01) * 0.25f;
+    if (center >= level) {
+      out.push_back({points[0][0], points[0][1], points[1][0], points[1][1],
+                     level});
+      out.push_back({points[2][0], points[2][1], points[3][0], points[3][1],
+                     level});
+    } else {
+      out.push_back({points[0][0], points[0][1], points[3][0], points[3][1],
+                     level});
+      out.push_back({points[1][0], points[1][1], points[2][0], points[2][1],
+                     level});
+    }
+  }
+}
+
+// Rows per worker band. Output does not depend on this value.
+constexpr int CONTOUR_BAND_ROWS = 64;
 
 void extract_contours(std::span<const float> heightmap, int width, int height,
                       float interval, std::vector<Line> &out_lines,
@@ -11,85 +76,97 @@ void extract_contours(std::span<const float> heightmap, int width, int height,
 
   int total = width * height;
   out_band_map.resize(total);
-  for (int i = 0; i < total; ++i) {
-    out_band_map[i] = (int)(heightmap[i] / interval);
-  }
 
-  for (float level = interval * 0.5f; level < 1.0f; level += interval) {
-    for (int y = 0; y < height - 1; ++y) {
-      for (int x = 0; x < width - 1; ++x) {
-        float h00 = heightmap[y * width + x];
-        float h10 = heightmap[y * width + x + 1];
-        float h01 = heightmap[(y + 1) * width + x];
-        float h11 = heightmap[(y + 1) * width + x + 1];
+  // Levels are accumulated exactly as the old per-level loop did so segment
+  // endpoints stay bit-identical.
+  std::vector<float> levels;
+  for (float level = interval * 0.5f; level < 1.0f; level += interval)
+    levels.push_back(level);
 
-        int config = ((h00 >= level) << 0) | ((h10 >= level) << 1) |
-                     ((h11 >= level) << 2) | ((h01 >= level) << 3);
+  // Each band owns a contiguous run of rows: it fills those rows of the band
+  // map and emits segments for the cells whose top edge lies in them, into
+  // one bucket per level.
+  int num_bands = (height + CONTOUR_BAND_ROWS - 1) / CONTOUR_BAND_ROWS;
+  std::vector<std::vector<std::vector<Line>>> band_lines(num_bands);
 
-        if (config == 0 || config == 15)
-          continue;
+  parallel_for(num_bands, [&](int band) {
+    int y0 = band * CONTOUR_BAND_ROWS;
+    int y1 = std::min(height, y0 + CONTOUR_BAND_ROWS);
 
-        float fx = (float)x, fy = (float)y;
-        float points[4][2];
-        int point_count = 0;
+    const float *hm = heightmap.data() + (size_t)y0 * width;
+    int *bm = out_band_map.data() + (size_t)y0 * width;
+    int n = (y1 - y0) * width;
+    for (int i = 0; i < n; ++i)
+      bm[i] = (int)(hm[i] / interval);
 
-        if ((h00 < level && h10 >= level) || (h00 >= level && h10 < level)) {
-          float t = (level - h00) / (h10 - h00);
-          points[point_count][0] = fx + t;
-          points[point_count][1] = fy;
-          point_count++;
-        }
+    auto &per_level = band_lines[band];
+    per_level.resize(levels.size());
+    if (levels.empty() || width < 2)
+      return;
 
-        if ((h10 < level && h11 >= level) || (h10 >= level && h11 < level)) {
-          float t = (level - h10) / (h11 - h10);
-          points[point_count][0] = fx + 1;
-          points[point_count][1] = fy + t;
-          point_count++;
-        }
+    const int cells_x = width - 1;
+    std::vector<float> cell_min(cells_x), cell_max(cells_x);
 
-        if ((h11 < level && h01 >= level) || (h11 >= level && h01 < level)) {
-          float t = (level - h11) / (h01 - h11);
-          points[point_count][0] = fx + 1 - t;
-          points[point_count][1] = fy + 1;
-          point_count++;
-        }
+    for (int y = y0; y < std::min(y1, height - 1); ++y) {
+      const float *row0 = heightmap.data() + (size_t)y * width;
+      const float *row1 = row0 + width;
 
-        if ((h01 < level && h00 >= level) || (h01 >= level && h00 < level)) {
-          float t = (level - h01) / (h00 - h01);
-          points[point_count][0] = fx;
-          points[point_count][1] = fy + 1 - t;
-          point_count++;
-        }
+      // Branch-free min/max over the 2x2 corners; vectorizes under -O3.
+      for (int x = 0; x < cells_x; ++x) {
+        float a = std::min(row0[x], row0[x + 1]);
+        float b = std::min(row1[x], row1[x + 1]);
+        float c = std::max(row0[x], row0[x + 1]);
+        float d = std::max(row1[x], row1[x + 1]);
+        cell_min[x] = std::min(a, b);
+        cell_max[x] = std::max(c, d);
+      }
 
-        if (point_count == 2) {
-          out_lines.push_back(
-              {points[0][0], points[0][1], points[1][0], points[1][1], level});
-        } else if (point_count == 4) {
-          float center = (h00 + h10 + h11 + h01) * 0.25f;
-          if (center >= level) {
-            out_lines.push_back({points[0][0], points[0][1], points[1][0],
-                                 points[1][1], level});
-            out_lines.push_back({points[2][0], points[2][1], points[3][0],
-                                 points[3][1], level});
-          } else {
-            out_lines.push_back({points[0][0], points[0][1], points[3][0],
-                                 points[3][1], level});
-            out_lines.push_back({points[1][0], points[1][1], points[2][0],
-                                 points[2][1], level});
-          }
+      for (int x = 0; x < cells_x; ++x) {
+        float lo = cell_min[x], hi = cell_max[x];
+        // Flat cells (the vast majority on a terraced map) cross nothing.
+        if (!(lo < hi))
+          continue;
+
+        // A level produces segments iff lo < level <= hi.
+        auto first = std::upper_bound(levels.begin(), levels.end(), lo);
+        auto last = std::upper_bound(first, levels.end(), hi);
+        if (first == last)
+          continue;
+
+        float h00 = row0[x], h10 = row0[x + 1];
+        float h01 = row1[x], h11 = row1[x + 1];
+        for (auto it = first; it != last; ++it) {
+          emit_cell_segments(*it, h00, h10, h01, h11, (float)x, (float)y,
+                             per_level[it - levels.begin()]);
         }
       }
     }
-  }
+  });
+
+  // Level-major, then band (row) order: identical to a serial sweep.
+  size_t total_lines = 0;
+  for (const auto &per_level : band_lines)
+    for (const auto &bucket : per_level)
+      total_lines += bucket.size();
+  out_lines.reserve(total_lines);
+  for (size_t l = 0; l < levels.size(); ++l)
+    for (const auto &per_level : band_lines)
+      out_lines.insert(out_lines.end(), per_level[l].begin(),
+                       per_level[l].end());
 }
 
 std::vector<Plateau> detect_plateaus(std::span<const int> band_map,
                                      std::span<const float> heightmap,
                                      int width, int height,
-                                     std::vector<int16_t>& terrain_map) {
+                                     std::vector<int16_t>& terrain_map,
+                                     RegionPixels &out_pixels) {
 
   std::vector<bool> visited(width * height, false);
   std::vector<Plateau> plateaus;
+  // Every pixel lands in exactly one flood region, so the map size bounds
+  // the store and the BFS never reallocates it.
+  out_pixels.clear();
+  out_pixels.reserve(0, (size_t)width * height);
 
   for (int y = 0; y < height; ++y) {
     for (int x = 0; x < width; ++x) {
@@ -116,7 +193,7 @@ std::vector<Plateau> detect_plateaus(std::span<const int> band_map,
         int current = queue.front();
         queue.pop();
 
-        plateau.pixels.push_back(current);
+        out_pixels.push(current);
 
         int cx = current % width;
         int cy = current / width;
@@ -151,25 +228,255 @@ std::vector<Plateau> detect_plateaus(std::span<const int> band_map,
 
       if (count > 50) {
         int16_t plateau_id = (int16_t)(plateaus.size() + 1);
-        for (int px_idx : plateau.pixels)
+        for (int px_idx : out_pixels.open_region())
           terrain_map[px_idx] = plateau_id;
+        out_pixels.close_region();
         plateaus.push_back(plateau);
+      } else {
+        out_pixels.discard_region();
       }
     }
   }
 
+  for (size_t i = 0; i < plateaus.size(); ++i)
+    plateaus[i].pixels = out_pixels[i];
+
   SDL_Log("Detected %zu plateaus", plateaus.size());
   return plateaus;
 }
 
-void simplify_contours(std::vector<Line> &lines, float epsilon) {
-  float eps2 = epsilon * epsilon;
-  size_t before = lines.size();
-  lines.erase(std::remove_if(lines.begin(), lines.end(), [eps2](const Line &l) {
-    float dx = l.x2 - l.x1;
-    float dy = l.y2 - l.y1;
-    return (dx * dx + dy * dy) < eps2;
-  }), lines.end());
-  SDL_Log("simplify_contours: %zu -> %zu segments (epsilon=%.2f)",
-          before, lines.size(), epsilon);
+static uint64_t point_key(float x, float y) {
+  uint32_t bx, by;
+  std::memcpy(&bx, &x, sizeof(bx));
+  std::memcpy(&by, &y, sizeof(by));
+  return ((uint64_t)bx << 32) | by;
+}
+
+void stitch_contours(std::span<const Line> lines, ContourPolylines &out) {
+  out.points.clear();
+  out.lines.clear();
+
+  // Segments of one level are contiguous in extract_contours output; a
+  // stable sort keeps that order and tolerates any other caller.
+  std::vector<int> order;
+  order.reserve(lines.size());
+  for (int i = 0; i < (int)lines.size(); ++i) {
+    const Line &l = lines[i];
+    if (l.x1 != l.x2 || l.y1 != l.y2)
+      order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return lines[a].elevation < lines[b].elevation;
+  });
+
+  struct Node {
+    float x, y;
+    int degree = 0;
+    int seg[2] = {-1, -1};
+  };
+  std::vector<Node> nodes;
+  std::vector<int> seg_nodes;
+  std::vector<uint8_t> seg_used;
+  std::unordered_map<uint64_t, int> node_of;
+
+  size_t group_begin = 0;
+  while (group_begin < order.size()) {
+    float level = lines[order[group_begin]].elevation;
+    size_t group_end = group_begin;
+    while (group_end < order.size() &&
+           lines[order[group_end]].elevation == level)
+      ++group_end;
+    int seg_count = (int)(group_end - group_begin);
+
+    nodes.clear();
+    node_of.clear();
+    node_of.reserve(seg_count * 2);
+    seg_nodes.assign(seg_count * 2, -1);
+    seg_used.assign(seg_count, 0);
+
+    auto node_for = [&](float x, float y) {
+      auto [it, inserted] = node_of.try_emplace(point_key(x, y),
+                                                (int)nodes.size());
+      if (inserted)
+        nodes.push_back({x, y});
+      return it->second;
+    };
+
+    for (int s = 0; s < seg_count; ++s) {
+      const Line &l = lines[order[group_begin + s]];
+      int a = node_for(l.x1, l.y1);
+      int b = node_for(l.x2, l.y2);
+      seg_nodes[s * 2] = a;
+      seg_nodes[s * 2 + 1] = b;
+      for (int n : {a, b}) {
+        Node &node = nodes[n];
+        if (node.degree < 2)
+          node.seg[node.degree] = s;
+        node.degree++;
+      }
+    }
+
+    // Follows unused segments from `start` until the chain ends, closes, or
+    // reaches a junction (degree != 2).
+    auto walk = [&](int start, int first_seg) {
+      ContourPolyline pl;
+      pl.elevation = level;
+      pl.first = (uint32_t)out.points.size();
+      out.points.push_back({nodes[start].x, nodes[start].y});
+
+      int cur = start, seg = first_seg;
+      while (seg >= 0 && !seg_used[seg]) {
+        seg_used[seg] = 1;
+        int next = seg_nodes[seg * 2] == cur ? seg_nodes[seg * 2 + 1]
+                                             : seg_nodes[seg * 2];
+        cur = next;
+        if (cur == start) {
+          pl.closed = true;
+          break;
+        }
+        out.points.push_back({nodes[cur].x, nodes[cur].y});
+        const Node &node = nodes[cur];
+        if (node.degree != 2)
+          break;
+        seg = node.seg[0] == seg ? node.seg[1] : node.seg[0];
+      }
+
+      pl.count = (uint32_t)out.points.size() - pl.first;
+      out.lines.push_back(pl);
+    };
+
+    // Open chains first, starting from their ends, then the remaining loops.
+    for (int n = 0; n < (int)nodes.size(); ++n) {
+      if (nodes[n].degree == 2)
+        continue;
+      for (int k = 0; k < std::min(nodes[n].degree, 2); ++k) {
+        int s = nodes[n].seg[k];
+        if (!seg_used[s])
+          walk(n, s);
+      }
+    }
+    for (int s = 0; s < seg_count; ++s) {
+      if (!seg_used[s])
+        walk(seg_nodes[s * 2], s);
+    }
+
+    group_begin = group_end;
+  }
+}
+
+static float point_segment_dist2(const Vec2 &p, const Vec2 &a, const Vec2 &b) {
+  float dx = b.x - a.x, dy = b.y - a.y;
+  float len2 = dx * dx + dy * dy;
+  float t = 0.0f;
+  if (len2 > 0.0f)
+    t = std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / len2, 0.0f, 1.0f);
+  float ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+  return ex * ex + ey * ey;
+}
+
+// Iterative Douglas-Peucker over pts[first..last], marking survivors in keep.
+static void douglas_peucker(const Vec2 *pts, int first, int last, float tol2,
+                            std::vector<uint8_t> &keep,
+                            std::vector<std::pair<int, int>> &stack) {
+  keep[first] = keep[last] = 1;
+  stack.clear();
+  stack.push_back({first, last});
+  while (!stack.empty()) {
+    auto [a, b] = stack.back();
+    stack.pop_back();
+    float max_d2 = tol2;
+    int max_i = -1;
+    for (int i = a + 1; i < b; ++i) {
+      float d2 = point_segment_dist2(pts[i], pts[a], pts[b]);
+      if (d2 > max_d2) {
+        max_d2 = d2;
+        max_i = i;
+      }
+    }
+    if (max_i >= 0) {
+      keep[max_i] = 1;
+      stack.push_back({a, max_i});
+      stack.push_back({max_i, b});
+    }
+  }
+}
+
+void simplify_contours(ContourPolylines &polylines, float tolerance) {
+  size_t before = polylines.points.size();
+  float tol2 = tolerance * tolerance;
+
+  std::vector<Vec2> points;
+  std::vector<ContourPolyline> lines;
+  points.reserve(before / 4);
+  lines.reserve(polylines.lines.size());
+
+  std::vector<Vec2> ring;
+  std::vector<uint8_t> keep;
+  std::vector<std::pair<int, int>> stack;
+
+  for (const auto &pl : polylines.lines) {
+    const Vec2 *src = polylines.points.data() + pl.first;
+    int n = (int)pl.count;
+    if (n < 2)
+      continue;
+
+    // A closed loop is split at the vertex farthest from its start so both
+    // halves have distinct anchors.
+    ring.assign(src, src + n);
+    int split = 0;
+    if (pl.closed) {
+      ring.push_back(src[0]);
+      float best = -1.0f;
+      for (int i = 1; i < n; ++i) {
+        float dx = src[i].x - src[0].x, dy = src[i].y - src[0].y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 > best) {
+          best = d2;
+          split = i;
+        }
+      }
+    }
+
+    int last = (int)ring.size() - 1;
+    keep.assign(ring.size(), 0);
+    if (pl.closed && split > 0) {
+      douglas_peucker(ring.data(), 0, split, tol2, keep, stack);
+      douglas_peucker(ring.data(), split, last, tol2, keep, stack);
+    } else {
+      douglas_peucker(ring.data(), 0, last, tol2, keep, stack);
+    }
+
+    ContourPolyline out = pl;
+    out.first = (uint32_t)points.size();
+    int end = pl.closed ? last : last + 1; // drop the repeated start
+    for (int i = 0; i < end; ++i)
+      if (keep[i])
+        points.push_back(ring[i]);
+    out.count = (uint32_t)points.size() - out.first;
+    // A loop thinner than the tolerance collapses to a single span.
+    if (out.closed && out.count < 3)
+      out.closed = false;
+    lines.push_back(out);
+  }
+
+  polylines.points = std::move(points);
+  polylines.lines = std::move(lines);
+  SDL_Log("simplify_contours: %zu -> %zu points in %zu polylines "
+          "(tolerance=%.2f)",
+          before, polylines.points.size(), polylines.lines.size(), tolerance);
+}
+
+void build_contour_lods(const ContourPolylines &stitched, float tolerance,
+                        int levels, std::vector<ContourPolylines> &out) {
+  out.assign(std::max(levels, 1), {});
+  out[0] = stitched;
+  simplify_contours(out[0], tolerance);
+  // Each level starts from the previous one. Tolerances double, so the
+  // deviation from the stitched line stays under twice the level's own
+  // tolerance, and every pass runs on an already thinned point set.
+  for (size_t i = 1; i < out.size(); ++i) {
+    tolerance *= 2.0f;
+    out[i] = out[i - 1];
+    simplify_contours(out[i], tolerance);
+  }
 }
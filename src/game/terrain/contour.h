@@ -1,4 +1,6 @@
 #pragma once
+#include "core/types.h"
+#include "terrain/region_pixels.h"
 #include <cstdint>
 #include <span>
 #include <vector>
@@ -12,12 +14,37 @@ void extract_contours(std::span<const float> heightmap, int width, int height,
                       float interval, std::vector<Line> &out_lines,
                       std::vector<int> &out_band_map);
 
-// Remove contour segments shorter than epsilon (world units) — call after extract_contours.
-void simplify_contours(std::vector<Line> &lines, float epsilon);
+// Contour segments joined into polylines. Each polyline is a run of
+// `count` points starting at `first` in the shared points array; closed
+// polylines connect their last point back to the first.
+struct ContourPolyline {
+  float elevation;
+  uint32_t first, count;
+  bool closed = false;
+};
+
+struct ContourPolylines {
+  std::vector<Vec2> points;
+  std::vector<ContourPolyline> lines;
+};
+
+// Joins extract_contours segments that share endpoints into polylines, one
+// level at a time.
+void stitch_contours(std::span<const Line> lines, ContourPolylines &out);
+
+// Douglas-Peucker simplification of every polyline; tolerance is the maximum
+// deviation in pixels.
+void simplify_contours(ContourPolylines &polylines, float tolerance);
+
+// Simplification pyramid over stitched polylines. Level 0 is simplified at
+// `tolerance`, each following level from the previous one at twice the
+// tolerance.
+void build_contour_lods(const ContourPolylines &stitched, float tolerance,
+                        int levels, std::vector<ContourPolylines> &out);
 
 struct Plateau {
   float height;
-  std::vector<int> pixels;
+  std::span<const int> pixels; // into the RegionPixels filled by detect_plateaus
   float center_x, center_y;
   float min_x, max_x, min_y, max_y;
 };
@@ -25,4 +52,5 @@ struct Plateau {
 std::vector<Plateau> detect_plateaus(std::span<const int> band_map,
                                      std::span<const float> heightmap,
                                      int width, int height,
-                                     std::vector<int16_t>& terrain_map);
+                                     std::vector<int16_t>& terrain_map,
+                                     RegionPixels &out_pixels);
@@ -0,0 +1,83 @@
+#include "terrain/distance_field.h"
+#include "core/parallel.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr float SQ_FAR = DISTANCE_FIELD_FAR * DISTANCE_FIELD_FAR;
+
+// Lower envelope of the parabolas y = f[q] + (x - q)^2 over one row, written
+// back as squared distances. v/z are caller scratch of size n and n + 1.
+static void envelope_1d(float *f, int n, std::vector<int> &v,
+                        std::vector<float> &z, std::vector<float> &d) {
+  int k = 0;
+  v[0] = 0;
+  z[0] = -SQ_FAR;
+  z[1] = SQ_FAR;
+  for (int q = 1; q < n; ++q) {
+    float s;
+    for (;;) {
+      int p = v[k];
+      s = ((f[q] + (float)q * q) - (f[p] + (float)p * p)) / (2.0f * (q - p));
+      if (s > z[k] || k == 0) // z[0] is -inf, so k == 0 always stops
+        break;
+      --k;
+    }
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = SQ_FAR;
+  }
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < (float)q)
+      ++k;
+    float dq = (float)(q - v[k]);
+    d[q] = dq * dq + f[v[k]];
+  }
+  std::copy(d.begin(), d.begin() + n, f);
+}
+
+void distance_transform(std::span<const uint8_t> seeds, int width, int height,
+                        std::vector<float> &out) {
+  int n = width * height;
+  out.resize(n);
+  if (n == 0)
+    return;
+
+  // Columns: squared distance to the nearest seed in the same column, via a
+  // downward then upward scan in row order.
+  std::vector<int> g(n);
+  const int far_steps = width + height;
+  for (int x = 0; x < width; ++x)
+    g[x] = seeds[x] ? 0 : far_steps;
+  for (int y = 1; y < height; ++y) {
+    const int *prev = &g[(y - 1) * width];
+    int *row = &g[y * width];
+    const uint8_t *s = &seeds[y * width];
+    for (int x = 0; x < width; ++x)
+      row[x] = s[x] ? 0 : prev[x] + 1;
+  }
+  for (int y = height - 2; y >= 0; --y) {
+    const int *next = &g[(y + 1) * width];
+    int *row = &g[y * width];
+    for (int x = 0; x < width; ++x)
+      row[x] = std::min(row[x], next[x] + 1);
+  }
+  for (int i = 0; i < n; ++i)
+    out[i] = g[i] >= far_steps ? SQ_FAR : (float)g[i] * g[i];
+
+  // Rows: parabola envelope over the column distances, in row bands.
+  constexpr int BAND = 32;
+  int bands = (height + BAND - 1) / BAND;
+  parallel_for(bands, [&](int b) {
+    std::vector<int> v(width);
+    std::vector<float> z(width + 1), d(width);
+    int y1 = std::min(height, (b + 1) * BAND);
+    for (int y = b * BAND; y < y1; ++y) {
+      float *row = &out[y * width];
+      envelope_1d(row, width, v, z, d);
+      for (int x = 0; x < width; ++x)
+        row[x] = row[x] >= SQ_FAR ? DISTANCE_FIELD_FAR : std::sqrt(row[x]);
+    }
+  });
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Exact Euclidean distance transform (Felzenszwalb & Huttenlocher), linear
+// in the pixel count. out[i] is the distance in pixels from pixel i to the
+// nearest pixel with seeds[] != 0; with no seeds at all every entry is
+// DISTANCE_FIELD_FAR.
+constexpr float DISTANCE_FIELD_FAR = 1e10f;
+
+void distance_transform(std::span<const uint8_t> seeds, int width, int height,
+                        std::vector<float> &out);
@@ -31,20 +31,25 @@ HexCoord pixel_to_hex(float x, float y, float hex_size) {
   return {iq, ir};
 }
 
-void get_hex_corners(int q, int r, float hex_size, Vec2 corners[6]) {
+static Vec2 unit_corner(int i) {
   const float PI = 3.14159265359f;
+  float angle = i * PI / 3.0f;
+  return {std::cos(angle), std::sin(angle)};
+}
+
+const Vec2 HEX_UNIT_CORNERS[6] = {unit_corner(0), unit_corner(1), unit_corner(2),
+                                  unit_corner(3), unit_corner(4), unit_corner(5)};
+
+void get_hex_corners(int q, int r, float hex_size, Vec2 corners[6]) {
   float cx, cy;
   hex_to_pixel(q, r, hex_size, cx, cy);
   for (int i = 0; i < 6; ++i) {
-    float angle = i * PI / 3.0f;
-    corners[i].x = cx + hex_size * std::cos(angle);
-    corners[i].y = cy + hex_size * std::sin(angle);
+    corners[i].x = cx + hex_size * HEX_UNIT_CORNERS[i].x;
+    corners[i].y = cy + hex_size * HEX_UNIT_CORNERS[i].y;
   }
 }
 
-bool pixel_in_hex(float px, float py, int q, int r, float hex_size) {
-  Vec2 corners[6];
-  get_hex_corners(q, r, hex_size, corners);
+bool pixel_in_hex(float px, float py, const Vec2 corners[6]) {
   for (int i = 0; i < 6; ++i) {
     int next = (i + 1) % 6;
     float edge_x = corners[next].x - corners[i].x;
@@ -57,6 +62,12 @@ bool pixel_in_hex(float px, float py, int q, int r, float hex_size) {
   return true;
 }
 
+bool pixel_in_hex(float px, float py, int q, int r, float hex_size) {
+  Vec2 corners[6];
+  get_hex_corners(q, r, hex_size, corners);
+  return pixel_in_hex(px, py, corners);
+}
+
 void compute_visible_edges(std::vector<HexColumn> &columns) {
   std::unordered_map<HexCoord, HexColumn *, HexHash> col_map;
   for (auto &col : columns) {
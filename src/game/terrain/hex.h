@@ -23,6 +23,11 @@ struct HexHash {
 
 void hex_to_pixel(int q, int r, float hex_size, float &out_x, float &out_y);
 HexCoord pixel_to_hex(float x, float y, float hex_size);
+// Corners of a unit-radius flat-top hex, at i * 60 degrees from +x.
+// get_hex_corners places them at centre + hex_size * HEX_UNIT_CORNERS[i].
+extern const Vec2 HEX_UNIT_CORNERS[6];
 void get_hex_corners(int q, int r, float hex_size, Vec2 corners[6]);
 bool pixel_in_hex(float px, float py, int q, int r, float hex_size);
+// Same test against corners already produced by get_hex_corners.
+bool pixel_in_hex(float px, float py, const Vec2 corners[6]);
 void compute_visible_edges(std::vector<HexColumn> &columns);
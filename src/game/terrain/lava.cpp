@@ -1,8 +1,11 @@
 #include "terrain/lava.h"
 #include "terrain/basalt.h"
 #include "terrain/color.h"
+#include "terrain/distance_field.h"
 #include "terrain/map_data.h"
+#include "terrain/morphology.h"
 #include "config.h"
+#include "core/parallel.h"
 #include "terrain/terrain_generator.h"
 #include "terrain/util.h"
 #include <SDL3/SDL.h>
@@ -98,129 +101,578 @@ static void triangulate_ear_clipping(const std::vector<P2> &P,
   }
 }
 
-static void trace_outline_4connected(const std::vector<uint8_t> &mask, int W,
-                                     int H, std::vector<P2> &out_poly) {
-  out_poly.clear();
-  int sx = -1, sy = -1;
-  for (int y = 0; y < H && sy < 0; ++y)
-    for (int x = 0; x < W; ++x)
-      if (mask[(size_t)y * W + x]) {
-        sx = x;
-        sy = y;
-        break;
+// Lava grids are meshed in square tiles of this many vertices per side, so
+// scratch memory per tile is fixed whatever the body size. A tile owns the
+// vertices in its block; the column/row just past it belongs to the
+// right/lower neighbour and is shared along the seam.
+constexpr int LAVA_MESH_TILE = 128;
+static_assert(LAVA_MESH_TILE % (1 << Config::LAVA_QUAD_MAX_LEVEL) == 0,
+              "quadtree blocks must not straddle mesh tiles");
+
+// Quadtree leaf over grid cells: a 2^level block whose corners are all lava
+// (level > 0), or a single cell meshed by its lava corners (level 0).
+struct LavaLeaf {
+  int i, j; // first cell, grid coordinates
+  int level;
+  bool fan = false; // edge carries neighbour corners; fan from the centre
+};
+
+struct LavaMeshTile {
+  int x0, y0;          // first owned grid vertex
+  int w, h;            // owned vertex block
+  int mw, mh;          // mask extent incl. the seam column/row, if any
+  uint32_t vertex_base = 0, vertex_count = 0;
+  uint32_t index_base = 0, index_count = 0;
+  std::vector<uint32_t> row_start; // owned vertices before each row
+  std::vector<uint32_t> first_row; // owned vertices before each column of row 0
+  std::vector<int8_t> cell_level;  // leaf level per owned cell, -1 = no cell
+  std::vector<LavaLeaf> leaves;
+  std::vector<uint8_t> centers;    // owned vertices added as fan centres
+};
+
+// Meshes a body over a grid_spacing lattice of its pixels. Interior areas
+// merge into quadtree leaves of up to 2^LAVA_QUAD_MAX_LEVEL cells, so vertex
+// count follows the shoreline rather than the area. A leaf whose edge holds
+// corners of smaller neighbours is fanned from its centre to all of them,
+// which keeps the surface free of T-junction cracks. Tiles are meshed with
+// parallel_for when `parallel` is set; callers already running one job per
+// body pass false.
+static void generate_lava_grid_mesh(LavaBody &lava, float grid_spacing,
+                                    bool parallel) {
+  lava.mesh.vertices.clear();
+  lava.mesh.indices.clear();
+
+  if (lava.runs.empty()) return;
+
+  int nx = (int)std::ceil((lava.max_x - lava.min_x) / grid_spacing) + 1;
+  int ny = (int)std::ceil((lava.max_y - lava.min_y) / grid_spacing) + 1;
+  int tiles_x = (nx + LAVA_MESH_TILE - 1) / LAVA_MESH_TILE;
+  int tiles_y = (ny + LAVA_MESH_TILE - 1) / LAVA_MESH_TILE;
+  int tile_count = tiles_x * tiles_y;
+  auto for_each_tile = [&](const std::function<void(int)> &fn) {
+    if (parallel)
+      parallel_for(tile_count, fn);
+    else
+      for (int t = 0; t < tile_count; ++t)
+        fn(t);
+  };
+
+  // Grid vertices sit on whole pixels (bbox corners are integral), so a
+  // vertex is lava exactly when a body pixel lands on it. Walk the lattice
+  // points inside each run and bucket them by owning tile with a counting
+  // pass.
+  int x0 = (int)lava.min_x, y0 = (int)lava.min_y;
+  int step = (int)grid_spacing;
+  auto for_each_grid_vertex = [&](auto &&fn) {
+    for (const PixelRun &run : lava.runs) {
+      int dy = run.y - y0;
+      if (dy < 0 || dy % step || dy / step >= ny)
+        continue;
+      int i = (std::max(run.x0 - x0, 0) + step - 1) / step;
+      for (; i < nx && x0 + i * step < run.x1; ++i)
+        fn(i, dy / step);
+    }
+  };
+  std::vector<uint32_t> bucket_start(tile_count + 1, 0);
+  for_each_grid_vertex([&](int i, int j) {
+    bucket_start[(j / LAVA_MESH_TILE) * tiles_x + i / LAVA_MESH_TILE + 1]++;
+  });
+  for (int t = 0; t < tile_count; ++t)
+    bucket_start[t + 1] += bucket_start[t];
+  std::vector<int> bucket(bucket_start[tile_count]);
+  {
+    std::vector<uint32_t> cursor(bucket_start.begin(), bucket_start.end() - 1);
+    for_each_grid_vertex([&](int i, int j) {
+      bucket[cursor[(j / LAVA_MESH_TILE) * tiles_x + i / LAVA_MESH_TILE]++] = j * nx + i;
+    });
+  }
+
+  std::vector<LavaMeshTile> tiles(tile_count);
+  for (int ty = 0; ty < tiles_y; ++ty) {
+    for (int tx = 0; tx < tiles_x; ++tx) {
+      auto &tile = tiles[ty * tiles_x + tx];
+      tile.x0 = tx * LAVA_MESH_TILE;
+      tile.y0 = ty * LAVA_MESH_TILE;
+      tile.w = std::min(LAVA_MESH_TILE, nx - tile.x0);
+      tile.h = std::min(LAVA_MESH_TILE, ny - tile.y0);
+      tile.mw = tile.w + (tx + 1 < tiles_x);
+      tile.mh = tile.h + (ty + 1 < tiles_y);
+    }
+  }
+
+  // Mask of the tile's vertices plus its seam, gathered from its own bucket
+  // and those of the right, lower and diagonal neighbours.
+  auto build_mask = [&](int t, std::vector<uint8_t> &mask) {
+    const auto &tile = tiles[t];
+    mask.assign(tile.mw * tile.mh, 0);
+    int tx = t % tiles_x, ty = t / tiles_x;
+    for (int oy = 0; oy < 2; ++oy) {
+      for (int ox = 0; ox < 2; ++ox) {
+        if (tx + ox >= tiles_x || ty + oy >= tiles_y)
+          continue;
+        int src = t + oy * tiles_x + ox;
+        for (uint32_t k = bucket_start[src]; k < bucket_start[src + 1]; ++k) {
+          int li = bucket[k] % nx - tile.x0, lj = bucket[k] / nx - tile.y0;
+          if (li < tile.mw && lj < tile.mh)
+            mask[lj * tile.mw + li] = 1;
+        }
       }
-  if (sx < 0)
-    return;
-  int dirs[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
-  int cx = sx, cy = sy, cd = 0;
-  auto inside = [&](int x, int y) {
-    return x >= 0 && y >= 0 && x < W && y < H;
+    }
   };
-  auto filled = [&](int x, int y) {
-    return inside(x, y) && mask[(size_t)y * W + x];
+
+  // Pass 1: per-tile quadtree. A block is full when all four children are;
+  // leaves are the largest full blocks plus every remaining single cell.
+  for_each_tile([&](int t) {
+    auto &tile = tiles[t];
+    std::vector<uint8_t> mask;
+    build_mask(t, mask);
+    int cw = tile.mw - 1, ch = tile.mh - 1;
+    tile.cell_level.assign(tile.w * tile.h, -1);
+
+    std::vector<std::vector<uint8_t>> full(Config::LAVA_QUAD_MAX_LEVEL + 1);
+    std::vector<int> fw(full.size()), fh(full.size());
+    fw[0] = std::max(cw, 0);
+    fh[0] = std::max(ch, 0);
+    full[0].resize(fw[0] * fh[0]);
+    for (int j = 0; j < fh[0]; ++j)
+      for (int i = 0; i < fw[0]; ++i) {
+        const uint8_t *m = &mask[j * tile.mw + i];
+        full[0][j * fw[0] + i] = m[0] && m[1] && m[tile.mw] && m[tile.mw + 1];
+      }
+    for (size_t l = 1; l < full.size(); ++l) {
+      fw[l] = (fw[l - 1] + 1) / 2;
+      fh[l] = (fh[l - 1] + 1) / 2;
+      full[l].assign(fw[l] * fh[l], 0);
+      for (int j = 0; 2 * j + 1 < fh[l - 1]; ++j)
+        for (int i = 0; 2 * i + 1 < fw[l - 1]; ++i) {
+          const uint8_t *c = &full[l - 1][2 * j * fw[l - 1] + 2 * i];
+          full[l][j * fw[l] + i] = c[0] && c[1] && c[fw[l - 1]] && c[fw[l - 1] + 1];
+        }
+    }
+
+    struct Block { int i, j, level; };
+    std::vector<Block> stack;
+    int top = Config::LAVA_QUAD_MAX_LEVEL;
+    for (int j = fh[top] - 1; j >= 0; --j)
+      for (int i = fw[top] - 1; i >= 0; --i)
+        stack.push_back({i, j, top});
+    while (!stack.empty()) {
+      Block b = stack.back();
+      stack.pop_back();
+      if (b.i >= fw[b.level] || b.j >= fh[b.level])
+        continue;
+      if (b.level > 0 && !full[b.level][b.j * fw[b.level] + b.i]) {
+        for (int k = 3; k >= 0; --k)
+          stack.push_back({2 * b.i + (k & 1), 2 * b.j + (k >> 1), b.level - 1});
+        continue;
+      }
+      int s = 1 << b.level;
+      tile.leaves.push_back({tile.x0 + b.i * s, tile.y0 + b.j * s, b.level});
+      for (int j = b.j * s; j < (b.j + 1) * s; ++j)
+        for (int i = b.i * s; i < (b.i + 1) * s; ++i)
+          tile.cell_level[j * tile.w + i] = (int8_t)b.level;
+    }
+  });
+
+  // A lava vertex is dropped when every cell around it belongs to a leaf
+  // that does not have it as a corner. Fan centres are added back below.
+  auto cell_level = [&](int ci, int cj) {
+    if (ci < 0 || cj < 0 || ci >= nx - 1 || cj >= ny - 1)
+      return -1;
+    const auto &tile = tiles[(cj / LAVA_MESH_TILE) * tiles_x + ci / LAVA_MESH_TILE];
+    return (int)tile.cell_level[(cj - tile.y0) * tile.w + (ci - tile.x0)];
   };
-  int loop_guard = 0;
-  do {
-    int left = (cd + 3) & 3;
-    int lx = cx + dirs[left][0];
-    int ly = cy + dirs[left][1];
-    if (filled(lx, ly)) {
-      cd = left;
-      cx = lx;
-      cy = ly;
-    } else {
-      int fx = cx + dirs[cd][0];
-      int fy = cy + dirs[cd][1];
-      if (filled(fx, fy)) {
-        cx = fx;
-        cy = fy;
+  auto is_leaf_corner = [&](int i, int j) {
+    bool any_cell = false;
+    for (int k = 0; k < 4; ++k) {
+      int ci = i - 1 + (k & 1), cj = j - 1 + (k >> 1);
+      int level = cell_level(ci, cj);
+      if (level < 0)
+        continue;
+      any_cell = true;
+      int s = 1 << level;
+      int di = i - (ci & ~(s - 1)), dj = j - (cj & ~(s - 1));
+      if ((di == 0 || di == s) && (dj == 0 || dj == s))
+        return true;
+    }
+    return !any_cell;
+  };
+
+  // Calls fn(i, j) for each vertex on a full leaf's perimeter, in the
+  // winding the grid triangles use.
+  auto walk_perimeter = [&](const LavaLeaf &leaf, auto &&fn) {
+    int s = 1 << leaf.level;
+    const int di[4] = {1, 0, -1, 0}, dj[4] = {0, 1, 0, -1};
+    int i = leaf.i, j = leaf.j;
+    for (int e = 0; e < 4; ++e)
+      for (int k = 0; k < s; ++k, i += di[e], j += dj[e])
+        if (k == 0 || is_leaf_corner(i, j))
+          fn(i, j);
+  };
+
+  auto cell_triangles = [](uint8_t v00, uint8_t v10, uint8_t v01, uint8_t v11) {
+    return (uint32_t)(v00 && v10 && v01) + (uint32_t)(v10 && v11 && v01);
+  };
+
+  // Pass 2: fan decisions, then per-tile vertex and triangle counts.
+  for_each_tile([&](int t) {
+    auto &tile = tiles[t];
+    std::vector<uint8_t> mask;
+    build_mask(t, mask);
+    tile.centers.assign(tile.w * tile.h, 0);
+    uint32_t tris = 0;
+    for (auto &leaf : tile.leaves) {
+      if (leaf.level == 0) {
+        const uint8_t *m = &mask[(leaf.j - tile.y0) * tile.mw + (leaf.i - tile.x0)];
+        tris += cell_triangles(m[0], m[1], m[tile.mw], m[tile.mw + 1]);
+        continue;
+      }
+      uint32_t perimeter = 0;
+      walk_perimeter(leaf, [&](int, int) { perimeter++; });
+      leaf.fan = perimeter > 4;
+      if (leaf.fan) {
+        int half = 1 << (leaf.level - 1);
+        tile.centers[(leaf.j + half - tile.y0) * tile.w + (leaf.i + half - tile.x0)] = 1;
+        tris += perimeter;
       } else {
-        cd = (cd + 1) & 3;
+        tris += 2;
       }
     }
-    float vx = cx + 0.5f;
-    float vy = cy + 0.5f;
-    if (out_poly.empty() || std::fabs(out_poly.back().x - vx) > 1e-4f ||
-        std::fabs(out_poly.back().y - vy) > 1e-4f) {
-      out_poly.push_back({vx, vy});
+
+    tile.row_start.resize(tile.h);
+    tile.first_row.resize(tile.w);
+    uint32_t verts = 0;
+    for (int j = 0; j < tile.h; ++j) {
+      tile.row_start[j] = verts;
+      for (int i = 0; i < tile.w; ++i) {
+        if (j == 0)
+          tile.first_row[i] = verts;
+        verts += mask[j * tile.mw + i] &&
+                 (tile.centers[j * tile.w + i] ||
+                  is_leaf_corner(tile.x0 + i, tile.y0 + j));
+      }
     }
-    if (++loop_guard > W * H * 8)
-      break;
-  } while (!(cx == sx && cy == sy && out_poly.size() > 2));
-  if (out_poly.size() >= 3 && poly_area(out_poly) < 0.0f)
-    std::reverse(out_poly.begin(), out_poly.end());
+    tile.vertex_count = verts;
+    tile.index_count = tris * 3;
+  });
+
+  uint32_t total_vertices = 0, total_indices = 0;
+  for (auto &tile : tiles) {
+    tile.vertex_base = total_vertices;
+    tile.index_base = total_indices;
+    total_vertices += tile.vertex_count;
+    total_indices += tile.index_count;
+  }
+  lava.mesh.vertices.resize(total_vertices);
+  lava.mesh.indices.resize(total_indices);
+
+  // Pass 3: emit each tile's vertices and triangles at its offsets. Seam
+  // vertices resolve to the neighbour's index from its row counts; they are
+  // always first in their row (right seam) or lie in row 0 (lower seam), and
+  // fan centres never sit on either.
+  for_each_tile([&](int t) {
+    const auto &tile = tiles[t];
+    std::vector<uint8_t> mask;
+    build_mask(t, mask);
+    auto is_vertex = [&](int li, int lj) {
+      if (!mask[lj * tile.mw + li])
+        return false;
+      if (li < tile.w && lj < tile.h && tile.centers[lj * tile.w + li])
+        return true;
+      return is_leaf_corner(tile.x0 + li, tile.y0 + lj);
+    };
+
+    std::vector<int> vertex_map(tile.mw * tile.mh, -1);
+    uint32_t next = tile.vertex_base;
+    for (int j = 0; j < tile.h; ++j) {
+      float wy = lava.min_y + (tile.y0 + j) * grid_spacing;
+      for (int i = 0; i < tile.w; ++i) {
+        if (!is_vertex(i, j))
+          continue;
+        vertex_map[j * tile.mw + i] = (int)next;
+        lava.mesh.vertices[next++] = {lava.min_x + (tile.x0 + i) * grid_spacing, wy,
+                                      lava.height};
+      }
+    }
+    if (tile.mw > tile.w) {
+      const auto &right = tiles[t + 1];
+      for (int j = 0; j < tile.h; ++j)
+        if (is_vertex(tile.w, j))
+          vertex_map[j * tile.mw + tile.w] = (int)(right.vertex_base + right.row_start[j]);
+    }
+    if (tile.mh > tile.h) {
+      const auto &below = tiles[t + tiles_x];
+      for (int i = 0; i < tile.w; ++i)
+        if (is_vertex(i, tile.h))
+          vertex_map[tile.h * tile.mw + i] = (int)(below.vertex_base + below.first_row[i]);
+      if (tile.mw > tile.w && is_vertex(tile.w, tile.h))
+        vertex_map[tile.h * tile.mw + tile.w] = (int)tiles[t + tiles_x + 1].vertex_base;
+    }
+    auto vertex_at = [&](int i, int j) {
+      return vertex_map[(j - tile.y0) * tile.mw + (i - tile.x0)];
+    };
+
+    uint32_t *out = lava.mesh.indices.data() + tile.index_base;
+    for (const auto &leaf : tile.leaves) {
+      int s = 1 << leaf.level;
+      int i00 = vertex_at(leaf.i, leaf.j);
+      int i10 = vertex_at(leaf.i + s, leaf.j);
+      int i01 = vertex_at(leaf.i, leaf.j + s);
+      int i11 = vertex_at(leaf.i + s, leaf.j + s);
+      if (leaf.fan) {
+        int centre = vertex_at(leaf.i + s / 2, leaf.j + s / 2);
+        int first = -1, prev = -1;
+        walk_perimeter(leaf, [&](int i, int j) {
+          int v = vertex_at(i, j);
+          if (prev >= 0) {
+            *out++ = centre;
+            *out++ = prev;
+            *out++ = v;
+          } else {
+            first = v;
+          }
+          prev = v;
+        });
+        *out++ = centre;
+        *out++ = prev;
+        *out++ = first;
+        continue;
+      }
+      if (i00 != -1 && i10 != -1 && i01 != -1) {
+        *out++ = i00;
+        *out++ = i10;
+        *out++ = i01;
+      }
+      if (i10 != -1 && i11 != -1 && i01 != -1) {
+        *out++ = i10;
+        *out++ = i11;
+        *out++ = i01;
+      }
+    }
+  });
 }
 
-static void generate_lava_grid_mesh(LavaBody &lava, int width, int height, float grid_spacing) {
+// Meshes a body by marching squares over a grid_spacing lattice. Each
+// lattice point samples the body mask through a tent filter two lattice
+// cells wide, and the shoreline is the 0.5 crossing of that coverage,
+// interpolated along cell edges. A straight pixel edge lands on the pixel
+// boundary and stairs smooth into slopes, so the grid can be coarser than
+// the pixel-sampled mesher for a cleaner outline.
+static void generate_lava_marching_mesh(LavaBody &lava, float grid_spacing) {
   lava.mesh.vertices.clear();
   lava.mesh.indices.clear();
 
-  if (lava.pixels.empty()) return;
-
-  if (lava.pixel_set.empty()) {
-    for (int idx : lava.pixels) lava.pixel_set.insert(idx);
+  if (lava.runs.empty()) return;
+
+  // The lattice reaches one cell past the bbox on every side; the tent
+  // covers less than half its mass there, so the outer ring is always
+  // outside and every shoreline closes.
+  int step = std::max((int)grid_spacing, 1);
+  int r = std::max(step / 2, 1);
+  int x0 = (int)lava.min_x - step, y0 = (int)lava.min_y - step;
+  int nx = ((int)lava.max_x + step - x0 + step - 1) / step + 1;
+  int ny = ((int)lava.max_y + step - y0 + step - 1) / step + 1;
+
+  // Tent of half-width 2r (a box of 2r + 1 pixels convolved with itself),
+  // as a cumulative table: cum[d + 2r] is the weight of offsets below d.
+  int span = 4 * r + 1;
+  std::vector<float> cum(span + 1, 0.0f);
+  for (int k = 0; k < span; ++k) {
+    int d = k - 2 * r;
+    cum[k + 1] = cum[k] + (float)(2 * r + 1 - std::abs(d)) / (float)((2 * r + 1) * (2 * r + 1));
   }
-
-  auto is_lava = [&](float x, float y) {
-    int ix = (int)std::round(x);
-    int iy = (int)std::round(y);
-    if (ix < 0 || ix >= width || iy < 0 || iy >= height) return false;
-    return lava.pixel_set.count(iy * width + ix) > 0;
+  auto below = [&](int d) {
+    return cum[std::clamp(d + 2 * r, 0, span)];
   };
 
-
-  int nx = (int)std::ceil((lava.max_x - lava.min_x) / grid_spacing) + 1;
-  int ny = (int)std::ceil((lava.max_y - lava.min_y) / grid_spacing) + 1;
-
-  // Guard against pathologically large lava bodies that would allocate
-  // hundreds of MB and freeze/OOM the system.
-  constexpr int MAX_LAVA_GRID_CELLS = 200 * 200; // ~40k cells max
-  if (nx * ny > MAX_LAVA_GRID_CELLS) {
-    lava.pixel_set.clear();
-    { std::unordered_set<int> empty; lava.pixel_set.swap(empty); }
-    return;
+  // Horizontal pass straight from the runs into pixel rows x lattice
+  // columns: a run covers a contiguous slice of each column's tent, so it
+  // adds a difference of two cumulative weights.
+  int hy0 = y0 - 2 * r;
+  int hh = (ny - 1) * step + span;
+  std::vector<float> rows((size_t)hh * nx, 0.0f);
+  for (const PixelRun &run : lava.runs) {
+    float *row = &rows[(size_t)(run.y - hy0) * nx];
+    int i0 = std::max((run.x0 - 2 * r - x0 + step - 1) / step, 0);
+    int i1 = std::min((run.x1 - 1 + 2 * r - x0) / step, nx - 1);
+    for (int i = i0; i <= i1; ++i) {
+      int c = x0 + i * step;
+      row[i] += below(run.x1 - c) - below(run.x0 - c);
+    }
   }
 
-  std::vector<int> vertex_map(nx * ny, -1);
-
+  // Vertical pass at lattice rows only; field holds coverage - 0.5.
+  std::vector<float> field((size_t)nx * ny, -0.5f);
   for (int j = 0; j < ny; ++j) {
-    for (int i = 0; i < nx; ++i) {
-      float wx = lava.min_x + i * grid_spacing;
-      float wy = lava.min_y + j * grid_spacing;
+    float *out = &field[(size_t)j * nx];
+    for (int k = 0; k < span; ++k) {
+      const float *row = &rows[(size_t)(j * step + k) * nx];
+      float w = cum[k + 1] - cum[k];
+      for (int i = 0; i < nx; ++i)
+        out[i] += w * row[i];
+    }
+  }
 
+  // Vertices are shared through per-point and per-edge index tables: corners
+  // by lattice point, crossings by the lattice point at the edge's start.
+  std::vector<int> corner_vertex((size_t)nx * ny, -1);
+  std::vector<int> hedge_vertex((size_t)nx * ny, -1);
+  std::vector<int> vedge_vertex((size_t)nx * ny, -1);
+  auto value = [&](int i, int j) { return field[(size_t)j * nx + i]; };
+  auto corner = [&](int i, int j) {
+    int &v = corner_vertex[(size_t)j * nx + i];
+    if (v < 0) {
+      v = (int)lava.mesh.vertices.size();
+      lava.mesh.vertices.push_back({(float)(x0 + i * step), (float)(y0 + j * step),
+                                    lava.height});
+    }
+    return v;
+  };
+  // Crossing on the edge from (i, j) one step along (di, dj).
+  auto crossing = [&](int i, int j, int di, int dj) {
+    int &v = (di ? hedge_vertex : vedge_vertex)[(size_t)j * nx + i];
+    if (v < 0) {
+      float a = value(i, j), b = value(i + di, j + dj);
+      float t = a / (a - b);
+      v = (int)lava.mesh.vertices.size();
+      lava.mesh.vertices.push_back({x0 + (i + di * t) * step, y0 + (j + dj * t) * step,
+                                    lava.height});
+    }
+    return v;
+  };
 
+  // Cells with all four corners inside merge into quadtree leaves as in the
+  // grid mesher; the rest are marched. used marks every lattice point that
+  // some leaf or marched cell takes as a corner.
+  int cw = nx - 1, ch = ny - 1;
+  std::vector<std::vector<uint8_t>> full(Config::LAVA_QUAD_MAX_LEVEL + 1);
+  std::vector<int> fw(full.size()), fh(full.size());
+  fw[0] = cw;
+  fh[0] = ch;
+  full[0].resize((size_t)cw * ch);
+  for (int j = 0; j < ch; ++j)
+    for (int i = 0; i < cw; ++i)
+      full[0][(size_t)j * cw + i] = value(i, j) > 0.0f && value(i + 1, j) > 0.0f &&
+                                    value(i, j + 1) > 0.0f && value(i + 1, j + 1) > 0.0f;
+  for (size_t l = 1; l < full.size(); ++l) {
+    fw[l] = (fw[l - 1] + 1) / 2;
+    fh[l] = (fh[l - 1] + 1) / 2;
+    full[l].assign((size_t)fw[l] * fh[l], 0);
+    for (int j = 0; 2 * j + 1 < fh[l - 1]; ++j)
+      for (int i = 0; 2 * i + 1 < fw[l - 1]; ++i) {
+        const uint8_t *c = &full[l - 1][2 * j * fw[l - 1] + 2 * i];
+        full[l][(size_t)j * fw[l] + i] = c[0] && c[1] && c[fw[l - 1]] && c[fw[l - 1] + 1];
+      }
+  }
 
-      if (is_lava(wx, wy)) {
-        vertex_map[j * nx + i] = (int)lava.mesh.vertices.size();
-        lava.mesh.vertices.push_back({wx, wy, lava.height});
+  std::vector<LavaLeaf> leaves;
+  std::vector<uint8_t> used((size_t)nx * ny, 0);
+  struct Block { int i, j, level; };
+  std::vector<Block> stack;
+  int top = Config::LAVA_QUAD_MAX_LEVEL;
+  for (int j = fh[top] - 1; j >= 0; --j)
+    for (int i = fw[top] - 1; i >= 0; --i)
+      stack.push_back({i, j, top});
+  while (!stack.empty()) {
+    Block b = stack.back();
+    stack.pop_back();
+    if (b.i >= fw[b.level] || b.j >= fh[b.level])
+      continue;
+    int s = 1 << b.level;
+    if (full[b.level][(size_t)b.j * fw[b.level] + b.i]) {
+      int i = b.i * s, j = b.j * s;
+      leaves.push_back({i, j, b.level});
+      used[(size_t)j * nx + i] = used[(size_t)j * nx + i + s] = 1;
+      used[(size_t)(j + s) * nx + i] = used[(size_t)(j + s) * nx + i + s] = 1;
+    } else if (b.level > 0) {
+      for (int k = 3; k >= 0; --k)
+        stack.push_back({2 * b.i + (k & 1), 2 * b.j + (k >> 1), b.level - 1});
+    } else {
+      leaves.push_back({b.i, b.j, -1}); // marched
+      for (int k = 0; k < 4; ++k) {
+        int i = b.i + (k & 1), j = b.j + (k >> 1);
+        if (value(i, j) > 0.0f)
+          used[(size_t)j * nx + i] = 1;
       }
     }
   }
 
-  for (int j = 0; j < ny - 1; ++j) {
-    for (int i = 0; i < nx - 1; ++i) {
-      int i00 = vertex_map[j * nx + i];
-      int i10 = vertex_map[j * nx + (i + 1)];
-      int i01 = vertex_map[(j + 1) * nx + i];
-      int i11 = vertex_map[(j + 1) * nx + (i + 1)];
-
-      if (i00 != -1 && i10 != -1 && i01 != -1) {
-        lava.mesh.indices.push_back(i00);
-        lava.mesh.indices.push_back(i10);
-        lava.mesh.indices.push_back(i01);
+  auto emit_fan = [&](const int *poly, int count) {
+    for (int k = 1; k + 1 < count; ++k) {
+      lava.mesh.indices.push_back(poly[0]);
+      lava.mesh.indices.push_back(poly[k]);
+      lava.mesh.indices.push_back(poly[k + 1]);
+    }
+  };
+  std::vector<int> perimeter;
+  for (const LavaLeaf &leaf : leaves) {
+    int i = leaf.i, j = leaf.j;
+    if (leaf.level >= 0) {
+      // Full leaf, fanned from its centre when a smaller neighbour puts
+      // corners on its edge.
+      int s = 1 << leaf.level;
+      perimeter.clear();
+      const int di[4] = {1, 0, -1, 0}, dj[4] = {0, 1, 0, -1};
+      int pi = i, pj = j;
+      for (int side = 0; side < 4; ++side)
+        for (int k = 0; k < s; ++k, pi += di[side], pj += dj[side])
+          if (k == 0 || used[(size_t)pj * nx + pi])
+            perimeter.push_back(corner(pi, pj));
+      if (perimeter.size() == 4) {
+        emit_fan(perimeter.data(), 4);
+      } else {
+        int centre = corner(i + s / 2, j + s / 2);
+        for (size_t k = 0; k < perimeter.size(); ++k) {
+          int tri[3] = {centre, perimeter[k], perimeter[(k + 1) % perimeter.size()]};
+          emit_fan(tri, 3);
+        }
       }
-      if (i10 != -1 && i11 != -1 && i01 != -1) {
-        lava.mesh.indices.push_back(i10);
-        lava.mesh.indices.push_back(i11);
-        lava.mesh.indices.push_back(i01);
+      continue;
+    }
+
+    // The inside part of a marched cell is its corners above zero plus the
+    // crossings between them, walked 00 -> 10 -> 11 -> 01. Those points all
+    // lie on the cell boundary in order, so the polygon is convex and fans
+    // from its first point. A saddle joins its two inside corners when the
+    // cell centre is inside and splits them otherwise.
+    const int ci[4] = {i, i + 1, i + 1, i};
+    const int cj[4] = {j, j, j + 1, j + 1};
+    float v[4];
+    int inside = 0;
+    for (int k = 0; k < 4; ++k) {
+      v[k] = value(ci[k], cj[k]);
+      inside |= (v[k] > 0.0f) << k;
+    }
+    if (!inside)
+      continue;
+
+    auto edge = [&](int k) {
+      int a = k, b = (k + 1) & 3;
+      // Edges are keyed from their top/left end.
+      int i0 = std::min(ci[a], ci[b]), j0 = std::min(cj[a], cj[b]);
+      return crossing(i0, j0, ci[a] != ci[b], cj[a] != cj[b]);
+    };
+    bool saddle = inside == 0b0101 || inside == 0b1010;
+    if (saddle && v[0] + v[1] + v[2] + v[3] <= 0.0f) {
+      for (int k = 0; k < 4; ++k) {
+        if (!(inside >> k & 1))
+          continue;
+        int tri[3] = {edge((k + 3) & 3), corner(ci[k], cj[k]), edge(k)};
+        emit_fan(tri, 3);
       }
+      continue;
     }
-  }
 
-  // pixel_set is only needed during mesh generation — free it now so that
-  // destructing a LavaBody on the main thread does not stall the render loop.
-  lava.pixel_set.clear();
-  { std::unordered_set<int> empty; lava.pixel_set.swap(empty); }
+    int poly[8], count = 0;
+    for (int k = 0; k < 4; ++k) {
+      bool in = inside >> k & 1, next_in = inside >> ((k + 1) & 3) & 1;
+      if (in)
+        poly[count++] = corner(ci[k], cj[k]);
+      if (in != next_in)
+        poly[count++] = edge(k);
+    }
+    emit_fan(poly, count);
+  }
 }
 
 static void build_triangle_mesh_from_polygon(const std::vector<P2> &poly,
@@ -248,7 +700,8 @@ static void build_triangle_mesh_from_polygon(const std::vector<P2> &poly,
 
 std::vector<ChannelRegion>
 extract_channel_spaces(std::span<const int16_t> terrain_map, int width,
-                       int height, std::span<const float> heightmap) {
+                       int height, std::span<const float> heightmap,
+                       RegionPixels &out_pixels) {
 
   SDL_Log("Phase 1.1: Extracting channel spaces from terrain_map");
 
@@ -263,6 +716,10 @@ extract_channel_spaces(std::span<const int16_t> terrain_map, int width,
   SDL_Log("  Channel pixels: %d / %d (%.1f%%)", channel_pixels, total_pixels,
           100.0f * channel_pixels / total_pixels);
 
+  // Every channel pixel lands in exactly one region.
+  out_pixels.clear();
+  out_pixels.reserve(0, channel_pixels);
+
   std::vector<uint8_t> visited(width * height, 0);
   std::vector<ChannelRegion> regions;
   const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
@@ -286,7 +743,7 @@ extract_channel_spaces(std::span<const int16_t> terrain_map, int width,
         int idx = q.front();
         q.pop();
         int cx = idx % width, cy = idx / width;
-        region.pixels.push_back(idx);
+        out_pixels.push(idx);
 
         min_x = std::min(min_x, (float)cx);
         max_x = std::max(max_x, (float)cx);
@@ -320,9 +777,12 @@ extract_channel_spaces(std::span<const int16_t> terrain_map, int width,
       float h = max_y - min_y + 1;
       region.aspect_ratio = std::max(w, h) / std::max(1.0f, std::min(w, h));
 
-      regions.push_back(std::move(region));
+      out_pixels.close_region();
+      regions.push_back(region);
     }
   }
+  for (size_t i = 0; i < regions.size(); ++i)
+    regions[i].pixels = out_pixels[i];
 
   SDL_Log("  Found %zu connected channel regions", regions.size());
 
@@ -346,103 +806,247 @@ extract_channel_spaces(std::span<const int16_t> terrain_map, int width,
 
   return regions;
 }
+
+// Distance from map pixels to the nearest column centre within `reach`.
+// A distance_transform seeded at the pixel under each centre answers all but
+// a thin band around `reach`, whose width is the largest seed offset; pixels
+// in the band are checked against the exact centres in a reach-sized bucket
+// grid, so the test matches measuring every column.
+struct ColumnCentreField {
+  float reach = 0.0f, slack = 0.0f;
+  int width = 0, bucket = 1, buckets_x = 0, buckets_y = 0;
+  std::vector<float> distance;
+  std::vector<P2> centres; // bucketed by bucket_start
+  std::vector<uint32_t> bucket_start;
+
+  void build(const std::vector<HexColumn> &columns, int w, int h, float r) {
+    width = w;
+    reach = r;
+    bucket = std::max(1, (int)std::ceil(r));
+    buckets_x = (w + bucket - 1) / bucket;
+    buckets_y = (h + bucket - 1) / bucket;
+
+    std::vector<uint8_t> seeds(w * h, 0);
+    std::vector<P2> exact(columns.size());
+    std::vector<int> home(columns.size());
+    bucket_start.assign(buckets_x * buckets_y + 1, 0);
+    for (size_t c = 0; c < columns.size(); ++c) {
+      hex_to_pixel(columns[c].q, columns[c].r, Config::HEX_SIZE, exact[c].x, exact[c].y);
+      int x = std::clamp((int)std::lround(exact[c].x), 0, w - 1);
+      int y = std::clamp((int)std::lround(exact[c].y), 0, h - 1);
+      seeds[y * w + x] = 1;
+      slack = std::max(slack, std::hypot(exact[c].x - x, exact[c].y - y));
+      home[c] = (y / bucket) * buckets_x + x / bucket;
+      bucket_start[home[c] + 1]++;
+    }
+    distance_transform(seeds, w, h, distance);
+
+    for (size_t b = 1; b < bucket_start.size(); ++b)
+      bucket_start[b] += bucket_start[b - 1];
+    centres.resize(columns.size());
+    std::vector<uint32_t> cursor(bucket_start.begin(), bucket_start.end() - 1);
+    for (size_t c = 0; c < columns.size(); ++c)
+      centres[cursor[home[c]]++] = exact[c];
+    slack += 1e-3f;
+  }
+
+  bool within_reach(int idx) const {
+    float d = distance[idx];
+    if (d < reach - slack)
+      return true;
+    if (d >= reach + slack)
+      return false;
+    int x = idx % width, y = idx / width;
+    int bx = x / bucket, by = y / bucket;
+    for (int j = std::max(by - 1, 0); j <= std::min(by + 1, buckets_y - 1); ++j)
+      for (int i = std::max(bx - 1, 0); i <= std::min(bx + 1, buckets_x - 1); ++i) {
+        int b = j * buckets_x + i;
+        for (uint32_t k = bucket_start[b]; k < bucket_start[b + 1]; ++k)
+          if (std::hypot(x - centres[k].x, y - centres[k].y) < reach)
+            return true;
+      }
+    return false;
+  }
+};
+
 std::vector<ChannelRegion>
-subdivide_large_regions(const std::vector<ChannelRegion> &regions,
+subdivide_large_regions(std::vector<ChannelRegion> &&regions,
                         const std::vector<HexColumn> &columns, int width,
-                        int height) {
+                        int height, RegionPixels &out_pixels) {
 
   std::vector<ChannelRegion> result;
+  result.reserve(regions.size());
+  std::vector<size_t> trimmed; // result index of each out_pixels region
+  ColumnCentreField near_columns; // built for the first large region
+  out_pixels.clear();
 
-  for (const auto &region : regions) {
+  for (auto &region : regions) {
     if (region.pixels.size() < 50000) {
-      result.push_back(region);
+      result.push_back(std::move(region));
       continue;
     }
+    if (near_columns.distance.empty())
+      near_columns.build(columns, width, height, Config::HEX_SIZE * 3.0f);
 
-    std::vector<uint8_t> mask(width * height, 0);
-    for (int idx : region.pixels) {
-      mask[idx] = 1;
-    }
-
-    std::vector<int> channel_pixels;
-
+    float min_x = width, max_x = 0, min_y = height, max_y = 0;
     for (int idx : region.pixels) {
-      int x = idx % width;
-      int y = idx / width;
-
-      float min_dist = 1e9f;
-      for (const auto &col : columns) {
-        Vec2 corners[6];
-        get_hex_corners(col.q, col.r, Config::HEX_SIZE, corners);
-
-        float cx = 0, cy = 0;
-        for (int i = 0; i < 6; ++i) {
-          cx += corners[i].x;
-          cy += corners[i].y;
-        }
-        cx /= 6.0f;
-        cy /= 6.0f;
-
-        float dist = std::hypot(x - cx, y - cy);
-        min_dist = std::min(min_dist, dist);
-      }
-
-      if (min_dist < Config::HEX_SIZE * 3.0f) {
-        channel_pixels.push_back(idx);
-      }
+      if (!near_columns.within_reach(idx))
+        continue;
+      out_pixels.push(idx);
+      float x = idx % width, y = idx / width;
+      min_x = std::min(min_x, x);
+      max_x = std::max(max_x, x);
+      min_y = std::min(min_y, y);
+      max_y = std::max(max_y, y);
     }
 
-    if (channel_pixels.size() > 1000) {
-      ChannelRegion sub;
-      sub.pixels = channel_pixels;
-      result.push_back(sub);
+    if (out_pixels.open_region().size() > 1000) {
+      out_pixels.close_region();
+      ChannelRegion part;
+      part.min_x = min_x;
+      part.max_x = max_x;
+      part.min_y = min_y;
+      part.max_y = max_y;
+      float w = max_x - min_x + 1, h = max_y - min_y + 1;
+      part.aspect_ratio = std::max(w, h) / std::max(1.0f, std::min(w, h));
+      part.avg_elevation = region.avg_elevation;
+      trimmed.push_back(result.size());
+      result.push_back(part);
+    } else {
+      out_pixels.discard_region();
     }
   }
+  for (size_t i = 0; i < trimmed.size(); ++i)
+    result[trimmed[i]].pixels = out_pixels[i];
 
+  if (!trimmed.empty())
+    SDL_Log("subdivide_large_regions: trimmed %zu large channels",
+            trimmed.size());
   return result;
 }
-static void fill_holes_in_region(ChannelRegion &region, int width, int height) {
-  std::unordered_set<int> pixel_set(region.pixels.begin(), region.pixels.end());
-
+// Rasterises `pixels` into a bitmap over their bounding box grown by one
+// pixel (clipped to the map); (x0, y0) is the map position of bit (0, 0).
+static void region_bitmap(std::span<const int> pixels, int width, int height,
+                          Bitmap &bm, int &x0, int &y0) {
   int min_x = width, max_x = 0, min_y = height, max_y = 0;
-  for (int idx : region.pixels) {
+  for (int idx : pixels) {
     int x = idx % width, y = idx / width;
     min_x = std::min(min_x, x);
     max_x = std::max(max_x, x);
     min_y = std::min(min_y, y);
     max_y = std::max(max_y, y);
   }
+  x0 = std::max(min_x - 1, 0);
+  y0 = std::max(min_y - 1, 0);
+  int x1 = std::min(max_x + 1, width - 1), y1 = std::min(max_y + 1, height - 1);
+  bm.reset(x1 - x0 + 1, y1 - y0 + 1);
+  for (int idx : pixels)
+    bm.set(idx % width - x0, idx / width - y0);
+}
 
-  for (int y = min_y; y <= max_y; ++y) {
-    for (int x = min_x; x <= max_x; ++x) {
-      int idx = y * width + x;
-      if (pixel_set.count(idx))
-        continue;
+// Traces the outer 4-connected boundary of a region through pixel centres,
+// starting from its first pixel in raster order. `scratch` holds the region
+// rasterised over its bounding box (see region_bitmap) and is reused across
+// calls, so no map-sized mask is touched.
+static void trace_region_outline(std::span<const int> pixels, int width,
+                                 int height, Bitmap &scratch,
+                                 std::vector<P2> &out_poly) {
+  out_poly.clear();
+  if (pixels.empty())
+    return;
+  int x0, y0;
+  region_bitmap(pixels, width, height, scratch, x0, y0);
+  const Bitmap &bm = scratch;
+  const int W = bm.width, H = bm.height;
 
-      int count = 0;
-      int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-      for (auto [dx, dy] : dirs) {
-        int nx = x + dx, ny = y + dy;
-        if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-          if (pixel_set.count(ny * width + nx))
-            count++;
-        }
+  int sx = -1, sy = -1;
+  for (int y = 0; y < H && sy < 0; ++y) {
+    const uint64_t *row = bm.row(y);
+    for (int k = 0; k < bm.stride; ++k)
+      if (row[k]) {
+        sx = k * 64 + std::countr_zero(row[k]);
+        sy = y;
+        break;
       }
-
-      if (count >= 3) {
-        region.pixels.push_back(idx);
-        pixel_set.insert(idx);
+  }
+  int dirs[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+  int cx = sx, cy = sy, cd = 0;
+  auto filled = [&](int x, int y) {
+    return x >= 0 && y >= 0 && x < W && y < H && bm.test(x, y);
+  };
+  int loop_guard = 0;
+  do {
+    int left = (cd + 3) & 3;
+    int lx = cx + dirs[left][0];
+    int ly = cy + dirs[left][1];
+    if (filled(lx, ly)) {
+      cd = left;
+      cx = lx;
+      cy = ly;
+    } else {
+      int fx = cx + dirs[cd][0];
+      int fy = cy + dirs[cd][1];
+      if (filled(fx, fy)) {
+        cx = fx;
+        cy = fy;
+      } else {
+        cd = (cd + 1) & 3;
       }
     }
+    float vx = x0 + cx + 0.5f;
+    float vy = y0 + cy + 0.5f;
+    if (out_poly.empty() || std::fabs(out_poly.back().x - vx) > 1e-4f ||
+        std::fabs(out_poly.back().y - vy) > 1e-4f) {
+      out_poly.push_back({vx, vy});
+    }
+    if (++loop_guard > W * H * 8)
+      break;
+  } while (!(cx == sx && cy == sy && out_poly.size() > 2));
+  if (out_poly.size() >= 3 && poly_area(out_poly) < 0.0f)
+    std::reverse(out_poly.begin(), out_poly.end());
+}
+
+// Pushes the region's pixels followed by the pixels set in `grown` but not
+// in `orig` (raster order) into the open region of `out`.
+static void push_grown_region(std::span<const int> pixels, const Bitmap &orig,
+                              const Bitmap &grown, int x0, int y0, int width,
+                              RegionPixels &out) {
+  for (int idx : pixels)
+    out.push(idx);
+  for (int y = 0; y < grown.height; ++y) {
+    const uint64_t *o = orig.row(y);
+    const uint64_t *g = grown.row(y);
+    for (int k = 0; k < grown.stride; ++k)
+      for (uint64_t w = g[k] & ~o[k]; w; w &= w - 1)
+        out.push((y0 + y) * width + x0 + k * 64 + std::countr_zero(w));
   }
 }
+
+// If closing the region's notches adds pixels, pushes the region's pixels
+// followed by them into the open region of `out` and returns true; a region
+// with nothing to fill is left alone. `orig` and `filled` are scratch reused
+// across calls.
+static bool fill_holes_in_region(std::span<const int> pixels, int width, int height,
+                                 Bitmap &orig, Bitmap &filled, RegionPixels &out) {
+  if (pixels.empty())
+    return false;
+  int x0, y0;
+  region_bitmap(pixels, width, height, orig, x0, y0);
+  fill_notches(orig, filled);
+  if (filled.words == orig.words)
+    return false;
+  push_grown_region(pixels, orig, filled, x0, y0, width, out);
+  return true;
+}
 std::vector<ChannelRegion>
-filter_lava_channels(const std::vector<ChannelRegion> &regions,
-                      std::span<const float> heightmap, int width, int height) {
+filter_lava_channels(std::vector<ChannelRegion> &&regions,
+                      std::span<const float> heightmap, int width, int height,
+                      RegionPixels &out_pixels) {
 
   std::vector<ChannelRegion> candidates;
+  candidates.reserve(regions.size());
 
-  for (const auto &region : regions) {
+  for (auto &region : regions) {
     float sum_h = 0;
     for (int idx : region.pixels)
       sum_h += heightmap[idx];
@@ -459,7 +1063,7 @@ filter_lava_channels(const std::vector<ChannelRegion> &regions,
     bool interior = !touches_boundary;
 
     if (interior && low_elevation && (is_river || is_pool || is_lake)) {
-      candidates.push_back(region);
+      candidates.push_back(std::move(region));
     }
   }
 
@@ -479,46 +1083,52 @@ filter_lava_channels(const std::vector<ChannelRegion> &regions,
               avg_h);
     }
   }
-  for (auto &candidate : candidates) {
-    fill_holes_in_region(candidate, width, height);
-  }
+  // Only candidates that hole filling grows are rebuilt in out_pixels; the
+  // rest keep their spans into the extract_channel_spaces store.
+  out_pixels.clear();
+  std::vector<size_t> rebuilt; // candidate index of each out_pixels region
+  Bitmap orig, filled;
+  for (size_t i = 0; i < candidates.size(); ++i)
+    if (fill_holes_in_region(candidates[i].pixels, width, height, orig, filled,
+                             out_pixels)) {
+      out_pixels.close_region();
+      rebuilt.push_back(i);
+    }
+  for (size_t k = 0; k < rebuilt.size(); ++k)
+    candidates[rebuilt[k]].pixels = out_pixels[k];
+  SDL_Log("Phase 3.1: %zu of %zu channels kept in place, %zu rebuilt with "
+          "filled notches (%zu pixels written)",
+          candidates.size() - rebuilt.size(), candidates.size(), rebuilt.size(),
+          out_pixels.indices.size());
 
   return candidates;
 }
 
-static void densify_region(std::vector<int> &pixels, int width, int height) {
-  std::unordered_set<int> pixel_set(pixels.begin(), pixels.end());
-  std::vector<int> to_add;
-
-  for (int idx : pixels) {
-    int x = idx % width;
-    int y = idx / width;
-
-    int neighbors[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
-    for (auto [dx, dy] : neighbors) {
-      int nx = x + dx, ny = y + dy;
-      if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-        int nidx = ny * width + nx;
-        if (!pixel_set.count(nidx)) {
-          to_add.push_back(nidx);
-          pixel_set.insert(nidx);
-        }
-      }
-    }
-  }
+// Pushes the runs of a bitmap placed at (x0, y0) on the map into the open
+// region of `out`.
+static void push_bitmap_runs(const Bitmap &bm, int x0, int y0, RegionRuns &out) {
+  bm.for_each_run([&](int y, int a, int b) { out.push(y0 + y, x0 + a, x0 + b); });
+}
 
-  pixels.insert(pixels.end(), to_add.begin(), to_add.end());
+// Pushes the runs of the region grown by its 4-neighbour ring into the open
+// region of `out`.
+static void densify_region(std::span<const int> pixels, int width, int height,
+                           RegionRuns &out) {
+  if (pixels.empty())
+    return;
+  Bitmap orig, grown;
+  int x0, y0;
+  region_bitmap(pixels, width, height, orig, x0, y0);
+  dilate4(orig, grown);
+  push_bitmap_runs(grown, x0, y0, out);
 }
+// Densified runs are left in the open region of `out_runs`; the caller
+// closes or discards it depending on whether the body is kept.
 static LavaBody channel_to_lava_body(const ChannelRegion &channel,
                                        std::span<const float> heightmap,
-                                       int width, int height, int channel_idx) {
-  std::vector<uint8_t> mask(width * height, 0);
-  for (int idx : channel.pixels) {
-    if (idx >= 0 && idx < width * height) {
-      mask[idx] = 1;
-    }
-  }
-
+                                       int width, int height, int channel_idx,
+                                       Bitmap &scratch,
+                                       RegionRuns &out_runs) {
   float sum_h = 0;
   for (int idx : channel.pixels) {
     sum_h += heightmap[idx];
@@ -526,7 +1136,7 @@ static LavaBody channel_to_lava_body(const ChannelRegion &channel,
   float avg_h = sum_h / channel.pixels.size();
 
   std::vector<P2> poly;
-  trace_outline_4connected(mask, width, height, poly);
+  trace_region_outline(channel.pixels, width, height, scratch, poly);
 
   if (poly.size() < 3) {
     SDL_Log("Channel %d: Failed to trace outline", channel_idx);
@@ -541,11 +1151,11 @@ static LavaBody channel_to_lava_body(const ChannelRegion &channel,
   lava.min_y = channel.min_y;
   lava.max_y = channel.max_y;
   lava.aspect_ratio = channel.aspect_ratio;
-  lava.pixels = channel.pixels;
-  densify_region(lava.pixels, width, height);
+  densify_region(channel.pixels, width, height, out_runs);
+  lava.runs = out_runs.open_region();
   lava.time_offset = (hash1d(channel_idx) % 1000) / 1000.0f * 6.283185f;
 
-  generate_lava_grid_mesh(lava, width, height, 2.0f);
+  generate_lava_grid_mesh(lava, 2.0f, true);
 
   SDL_Log("Channel %d: Created lava body with %zu vertices", channel_idx,
           lava.mesh.vertices.size());
@@ -556,17 +1166,31 @@ static LavaBody channel_to_lava_body(const ChannelRegion &channel,
 std::vector<LavaBody>
 channels_to_lava_bodies(const std::vector<ChannelRegion> &channels,
                          std::span<const float> heightmap, int width,
-                         int height) {
+                         int height, RegionRuns &out_runs) {
 
   std::vector<LavaBody> lava_bodies;
-
+  // At least one run per densified row.
+  size_t rows = 0;
+  for (const auto &channel : channels)
+    rows += (size_t)(channel.max_y - channel.min_y) + 3;
+  out_runs.clear();
+  out_runs.reserve(channels.size(), rows);
+
+  Bitmap scratch;
   for (size_t i = 0; i < channels.size(); ++i) {
-    LavaBody lava =
-        channel_to_lava_body(channels[i], heightmap, width, height, (int)i);
+    LavaBody lava = channel_to_lava_body(channels[i], heightmap, width, height,
+                                         (int)i, scratch, out_runs);
     if (!lava.mesh.vertices.empty()) {
+      out_runs.close_region();
       lava_bodies.push_back(std::move(lava));
+    } else {
+      out_runs.discard_region();
     }
   }
+  // Runs may have grown the store past its reservation; point the bodies at
+  // their final ranges.
+  for (size_t i = 0; i < lava_bodies.size(); ++i)
+    lava_bodies[i].runs = out_runs[i];
 
   SDL_Log("Created %zu lava bodies from %zu channels", lava_bodies.size(),
           channels.size());
@@ -575,7 +1199,9 @@ channels_to_lava_bodies(const std::vector<ChannelRegion> &channels,
 std::vector<LavaBody>
 identify_lava_bodies(std::span<const float> heightmap, int width, int height,
                       const std::vector<Plateau> &plateaus,
-                      const std::vector<int> &plateaus_with_columns) {
+                      const std::vector<int> &plateaus_with_columns,
+                      RegionRuns &out_runs) {
+  out_runs.clear();
   std::unordered_set<int> used(plateaus_with_columns.begin(),
                                plateaus_with_columns.end());
   float min_plateau_h = 1e9f;
@@ -603,14 +1229,10 @@ identify_lava_bodies(std::span<const float> heightmap, int width, int height,
 
   std::vector<LavaBody> out;
 
+  Bitmap scratch;
   for (int pi : candidates) {
     const auto &plat = plateaus[pi];
 
-    std::vector<uint8_t> mask((size_t)width * height, 0);
-    for (int idx : plat.pixels)
-      if ((uint32_t)idx < mask.size())
-        mask[idx] = 1;
-
     float min_x = 1e9f, max_x = -1e9f, min_y = 1e9f, max_y = -1e9f;
     for (int idx : plat.pixels) {
       int x = idx % width, y = idx / width;
@@ -621,7 +1243,7 @@ identify_lava_bodies(std::span<const float> heightmap, int width, int height,
     }
 
     std::vector<P2> poly_px;
-    trace_outline_4connected(mask, width, height, poly_px);
+    trace_region_outline(plat.pixels, width, height, scratch, poly_px);
     if (poly_px.size() < 3) {
       SDL_Log("Lava: plateau %d produced no polygon outline", pi);
       continue;
@@ -645,14 +1267,23 @@ identify_lava_bodies(std::span<const float> heightmap, int width, int height,
     lava.max_y = max_y;
     float w = max_x - min_x + 1.f, h = max_y - min_y + 1.f;
     lava.aspect_ratio = std::max(w, h) / std::max(1.0f, std::min(w, h));
-    lava.pixels = plat.pixels;
+    int bx, by;
+    region_bitmap(plat.pixels, width, height, scratch, bx, by);
+    push_bitmap_runs(scratch, bx, by, out_runs);
+    lava.runs = out_runs.open_region();
     lava.time_offset = (hash1d(pi) % 1000) / 1000.0f * 6.283185f;
 
-    generate_lava_grid_mesh(lava, width, height, 2.0f);
+    generate_lava_grid_mesh(lava, 2.0f, true);
 
-    if (!lava.mesh.vertices.empty())
+    if (!lava.mesh.vertices.empty()) {
+      out_runs.close_region();
       out.push_back(std::move(lava));
+    } else {
+      out_runs.discard_region();
+    }
   }
+  for (size_t i = 0; i < out.size(); ++i)
+    out[i].runs = out_runs[i];
 
   SDL_Log("Lava: produced %zu triangle bodies from %zu unused candidates",
           out.size(), candidates.size());
@@ -668,27 +1299,70 @@ float get_lava_height(float x, float y, float base_z, float time,
   return base_z + wave1 + wave2 + wave3;
 }
 
+// Branch-free sine for get_lava_heights: Cody-Waite reduction to [-pi, pi],
+// fold onto [-pi/2, pi/2] via sin(pi - r) = sin(r), then a degree-11 odd
+// Taylor polynomial. Only plain arithmetic, so the batch loop vectorises
+// (std::floor would block that under the default trapping-math rules).
+static inline float lava_sin(float a) {
+  constexpr float INV_TWO_PI = 0.159154943f;
+  constexpr float TWO_PI_HI = 6.28125f; // exact in 8 bits, so k * HI is exact
+  constexpr float TWO_PI_LO = 1.9353071795864769e-3f;
+  constexpr float PI = 3.14159265f;
+  constexpr float ROUND = 12582912.0f; // 1.5 * 2^23: adding it rounds to int
+  float k = (a * INV_TWO_PI + ROUND) - ROUND;
+  float r = (a - k * TWO_PI_HI) - k * TWO_PI_LO;
+  // r can land just past +-pi, so PI - |r| may be slightly negative; keep
+  // that sign and apply r's separately.
+  float m = std::min(std::fabs(r), PI - std::fabs(r));
+  float x = std::copysign(1.0f, r) * m;
+  float x2 = x * x;
+  return x * (1.0f + x2 * (-1.66666667e-1f + x2 * (8.33333333e-3f +
+              x2 * (-1.98412698e-4f + x2 * (2.75573192e-6f + x2 * -2.50521084e-8f)))));
+}
+
+void get_lava_heights(std::span<const float> xs, std::span<const float> ys,
+                      std::span<const float> base_z,
+                      std::span<const float> time_offsets, float time,
+                      std::span<float> out) {
+  const size_t n = out.size();
+  const float *x = xs.data(), *y = ys.data();
+  const float *bz = base_z.data(), *to = time_offsets.data();
+  float *o = out.data();
+  for (size_t i = 0; i < n; ++i) {
+    float t = time + to[i];
+    float wave1 = lava_sin(x[i] * 0.3f + t) * 0.02f;
+    float wave2 = lava_sin(y[i] * 0.21f + t * 1.3f) * 0.015f;
+    float wave3 = lava_sin((x[i] + y[i]) * 0.15f + t * 0.8f) * 0.01f;
+    o[i] = bz[i] + wave1 + wave2 + wave3;
+  }
+}
+
 
 
-FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int seed) {
+FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int seed,
+                                       bool smooth_shore) {
   int width = data.width;
   int height = data.height;
   int n = width * height;
 
   std::vector<bool> visited(n, false);
   FloodFillResult result;
+  std::vector<uint32_t> &labels = result.labels;
+  labels.assign(n, 0);
 
   const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
 
+  // Each body's lava/void draw is keyed by the map seed and the body's first
+  // pixel in raster order, so it does not depend on how many bodies were
+  // classified before it.
+  uint64_t rng_key = splitmix64(((uint64_t)(uint32_t)seed << 32) ^
+                                ((uint64_t)width << 16) ^ (uint64_t)height);
 
-  uint32_t rng_seed = 0xDEADBEEFu;
-  rng_seed ^= (uint32_t)width + 0x9e3779b9u + (rng_seed << 6) + (rng_seed >> 2);
-  rng_seed ^= (uint32_t)height + 0x9e3779b9u + (rng_seed << 6) + (rng_seed >> 2);
-  rng_seed ^= (uint32_t)seed + 0x9e3779b9u + (rng_seed << 6) + (rng_seed >> 2);
-  std::mt19937 rng(rng_seed);
-  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-
-  int body_index = 0;
+  // Flood fill stays serial; kept components are labelled 1 + body index
+  // and each body records its first pixel.
+  std::vector<LavaBody> bodies;
+  std::vector<int> body_start;
+  std::vector<int> component; // BFS queue, then the component's pixels
 
   for (int sy = 0; sy < height; ++sy) {
     for (int sx = 0; sx < width; ++sx) {
@@ -696,18 +1370,15 @@ FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int see
       if (visited[start] || data.terrain_map[start] == TERRAIN_BASALT)
         continue;
 
-      std::vector<int> component_pixels;
-      std::queue<int> q;
-      q.push(start);
+      component.clear();
+      component.push_back(start);
       visited[start] = true;
 
       float mn_x = (float)sx, mx_x = (float)sx;
       float mn_y = (float)sy, mx_y = (float)sy;
 
-      while (!q.empty()) {
-        int idx = q.front();
-        q.pop();
-        component_pixels.push_back(idx);
+      for (size_t head = 0; head < component.size(); ++head) {
+        int idx = component[head];
         int cx = idx % width, cy = idx / width;
 
         mn_x = std::min(mn_x, (float)cx);
@@ -721,17 +1392,18 @@ FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int see
             int nidx = ny * width + nx;
             if (!visited[nidx] && data.terrain_map[nidx] != TERRAIN_BASALT) {
               visited[nidx] = true;
-              q.push(nidx);
+              component.push_back(nidx);
             }
           }
         }
       }
 
-      if (component_pixels.size() < 50)
+      if (component.size() < 50)
         continue;
 
-      bool is_void = dist(rng) < void_chance;
-      int16_t terrain_type = is_void ? TERRAIN_VOID : TERRAIN_LAVA;
+      uint32_t label = (uint32_t)bodies.size() + 1;
+      for (int idx : component)
+        labels[idx] = label;
 
       LavaBody body;
       body.plateau_index = -1;
@@ -742,25 +1414,85 @@ FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int see
       body.max_y = mx_y;
       float bw = mx_x - mn_x + 1.f, bh = mx_y - mn_y + 1.f;
       body.aspect_ratio = std::max(bw, bh) / std::max(1.0f, std::min(bw, bh));
-      body.pixels = std::move(component_pixels);
       body.time_offset =
-          (hash1d(body_index++) % 1000) / 1000.0f * 6.283185f;
+          (hash1d((int)bodies.size()) % 1000) / 1000.0f * 6.283185f;
+      bodies.push_back(std::move(body));
+      body_start.push_back(start);
+    }
+  }
 
-      if (!is_void) {
-        generate_lava_grid_mesh(body, width, height, 2.0f);
+  // Row runs straight from the label image: count runs per body, then lay
+  // the store out CSR-style and fill it in a second raster pass, which
+  // leaves every body's runs sorted by row.
+  auto for_each_label_run = [&](auto &&fn) {
+    for (int y = 0; y < height; ++y) {
+      const uint32_t *row = &labels[(size_t)y * width];
+      for (int x = 0; x < width;) {
+        uint32_t label = row[x];
+        int x0 = x;
+        while (x < width && row[x] == label)
+          ++x;
+        if (label)
+          fn(label - 1, y, x0, x);
       }
+    }
+  };
+  RegionRuns &store = result.runs;
+  store.offsets.assign(bodies.size() + 1, 0);
+  for_each_label_run([&](uint32_t b, int, int, int) { store.offsets[b + 1]++; });
+  for (size_t b = 0; b < bodies.size(); ++b)
+    store.offsets[b + 1] += store.offsets[b];
+  store.runs.resize(store.offsets.back());
+  {
+    std::vector<uint32_t> cursor(store.offsets.begin(), store.offsets.end() - 1);
+    for_each_label_run([&](uint32_t b, int y, int x0, int x1) {
+      store.runs[cursor[b]++] = {y, x0, x1};
+    });
+  }
+  for (size_t b = 0; b < bodies.size(); ++b)
+    bodies[b].runs = store[b];
+
+  // Bodies own disjoint pixels, so classification, meshing and the
+  // terrain_map stamp run per body in parallel.
+  std::vector<uint8_t> is_void(bodies.size());
+  parallel_for((int)bodies.size(), [&](int b) {
+    LavaBody &body = bodies[b];
+    is_void[b] =
+        hash_to_unit(splitmix64(rng_key ^ (uint64_t)body_start[b])) < void_chance;
+    int16_t terrain_type = is_void[b] ? TERRAIN_VOID : TERRAIN_LAVA;
+
+    if (!is_void[b]) {
+      if (smooth_shore)
+        generate_lava_marching_mesh(body, 4.0f);
+      else
+        generate_lava_grid_mesh(body, 2.0f, false);
+    }
 
-      for (int idx : body.pixels) {
-        if (data.terrain_map[idx] != TERRAIN_BASALT)
-          data.terrain_map[idx] = terrain_type;
-      }
+    for_each_run_pixel(body.runs, width,
+                       [&](int idx) { data.terrain_map[idx] = terrain_type; });
+  });
 
-      if (is_void)
-        result.void_bodies.push_back(std::move(body));
-      else
-        result.lava_bodies.push_back(std::move(body));
+  std::vector<uint32_t> final_label(bodies.size());
+  for (size_t b = 0; b < bodies.size(); ++b) {
+    if (is_void[b]) {
+      final_label[b] = ((uint32_t)result.void_bodies.size() + 1) | BODY_LABEL_VOID;
+      result.void_bodies.push_back(std::move(bodies[b]));
+    } else {
+      final_label[b] = (uint32_t)result.lava_bodies.size() + 1;
+      result.lava_bodies.push_back(std::move(bodies[b]));
     }
   }
+  parallel_for((int)final_label.size(), [&](int b) {
+    const auto &body = is_void[b]
+        ? result.void_bodies[(final_label[b] & ~BODY_LABEL_VOID) - 1]
+        : result.lava_bodies[final_label[b] - 1];
+    for_each_run_pixel(body.runs, width, [&](int idx) { labels[idx] = final_label[b]; });
+  });
+
+  std::vector<uint8_t> lava_mask(n);
+  for (int i = 0; i < n; ++i)
+    lava_mask[i] = data.terrain_map[i] == TERRAIN_LAVA;
+  distance_transform(lava_mask, width, height, data.lava_distance);
 
   SDL_Log("generate_lava_and_void: %zu lava bodies, %zu void bodies",
           result.lava_bodies.size(), result.void_bodies.size());
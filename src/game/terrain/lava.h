@@ -2,15 +2,16 @@
 #pragma once
 #include "terrain/basalt.h"
 #include "terrain/contour.h"
+#include "terrain/region_pixels.h"
+#include "terrain/region_runs.h"
 #include <cstdint>
 #include <span>
-#include <unordered_set>
 #include <vector>
 
 struct MapData;
 
 struct ChannelRegion {
-  std::vector<int> pixels;
+  std::span<const int> pixels; // into the RegionPixels of the producing pass
   float min_x, max_x, min_y, max_y;
   float aspect_ratio;
   float avg_elevation;
@@ -34,10 +35,9 @@ struct LavaBody {
   float min_x = 0, max_x = 0;
   float min_y = 0, max_y = 0;
   float aspect_ratio = 0.f;
-  std::vector<int> pixels;
+  std::span<const PixelRun> runs; // into the owner's RegionRuns
   float time_offset = 0.f;
   LavaMesh mesh;
-  std::unordered_set<int> pixel_set;
 };
 
 struct WaveParams {
@@ -48,19 +48,33 @@ struct WaveParams {
 
 std::vector<ChannelRegion>
 extract_channel_spaces(std::span<const int16_t> terrain_map, int width,
-                       int height, std::span<const float> heightmap);
+                       int height, std::span<const float> heightmap,
+                       RegionPixels &out_pixels);
 
+// Consumes the extracted regions. Kept regions whose notches need no
+// filling still point into the extract_channel_spaces store; grown ones
+// point into out_pixels, so both stores must outlive the result.
 std::vector<ChannelRegion>
-filter_lava_channels(const std::vector<ChannelRegion> &regions,
-                      std::span<const float> heightmap, int width, int height);
+filter_lava_channels(std::vector<ChannelRegion> &&regions,
+                      std::span<const float> heightmap, int width, int height,
+                      RegionPixels &out_pixels);
+// Trims regions of 50k+ pixels to the pixels within three hex sizes of a
+// column centre, dropping those left with 1000 pixels or fewer. Small
+// regions keep their spans into the input store; trimmed ones point into
+// out_pixels, so both stores must outlive the result.
+std::vector<ChannelRegion>
+subdivide_large_regions(std::vector<ChannelRegion> &&regions,
+                        const std::vector<HexColumn> &columns, int width,
+                        int height, RegionPixels &out_pixels);
 std::vector<LavaBody>
 channels_to_lava_bodies(const std::vector<ChannelRegion> &channels,
                          std::span<const float> heightmap, int width,
-                         int height);
+                         int height, RegionRuns &out_runs);
 std::vector<LavaBody>
 identify_lava_bodies(std::span<const float> heightmap, int width, int height,
                       const std::vector<Plateau> &plateaus,
-                      const std::vector<int> &plateaus_with_columns);
+                      const std::vector<int> &plateaus_with_columns,
+                      RegionRuns &out_runs);
 
 void generate_lava_mesh_masked(LavaBody &lava,
                                 const std::vector<uint8_t> &mask, int mask_w,
@@ -69,11 +83,30 @@ void generate_lava_mesh_masked(LavaBody &lava,
 float get_lava_height(float x, float y, float base_z, float time,
                        float time_offset);
 
+// Batch get_lava_height over out.size() points (the inputs must be at least
+// as long), with a vectorisable sine. Each sine is within 3e-7 of the exact
+// sine of the same float phase while phases stay below 1e4 rad (about two
+// hours of lava time), so heights stay within 2e-8 of the lava.vert formula
+// apart from float rounding of the phases and sum, which the GPU shares.
+void get_lava_heights(std::span<const float> xs, std::span<const float> ys,
+                      std::span<const float> base_z,
+                      std::span<const float> time_offsets, float time,
+                      std::span<float> out);
+
+// Body label image values: 0 = no body, otherwise 1 + index into
+// lava_bodies, or into void_bodies when BODY_LABEL_VOID is set.
+constexpr uint32_t BODY_LABEL_VOID = 0x80000000u;
+
 struct FloodFillResult {
   std::vector<LavaBody> lava_bodies;
   std::vector<LavaBody> void_bodies;
+  RegionRuns runs;             // backs the run spans of both body lists
+  std::vector<uint32_t> labels; // width * height body labels
 };
 
-FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int seed = 0);
+// smooth_shore meshes lava bodies by marching squares over a filtered mask
+// instead of the pixel-sampled quadtree grid.
+FloodFillResult generate_lava_and_void(MapData &data, float void_chance, int seed = 0,
+                                       bool smooth_shore = false);
 
 
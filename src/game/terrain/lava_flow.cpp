@@ -0,0 +1,265 @@
+#include "terrain/lava_flow.h"
+#include "terrain/map_data.h"
+#include "config.h"
+#include "core/parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Map pixels per cell side. Coarser than a pixel so lava crosses a body in
+// seconds rather than minutes; still finer than the lava mesh grid.
+constexpr int LAVA_FLOW_CELL = 4;
+// Cells per tile side; a tile is the unit of activity tracking and of
+// parallel work.
+constexpr int LAVA_FLOW_TILE = 32;
+// Fraction of the surface difference moved to each lower neighbour per
+// step. Four neighbours at <= 0.25 keep the update stable.
+constexpr float LAVA_FLOW_RATE = 0.2f;
+// Erupted volume per body, as a mean depth (basalt_height units) over its
+// cells, released evenly over LAVA_FLOW_ERUPTION_SECONDS.
+constexpr float LAVA_FLOW_FILL_DEPTH = 0.04f;
+constexpr float LAVA_FLOW_ERUPTION_SECONDS = 20.0f;
+// A tile whose cells all moved less than this in a step goes to sleep.
+constexpr float LAVA_FLOW_EPSILON = 1e-4f;
+constexpr float LAVA_FLOW_STEP = 1.0f / 60.0f;
+constexpr int LAVA_FLOW_MAX_SUBSTEPS = 4;
+
+// Outflow limiter for one row of n cells: the fraction of its wanted outflow
+// each cell can pay from its depth. Branchless so the loop vectorises.
+static void outflow_row(const float *g, const float *d, const float *open,
+                        float *scale, int n, int stride) {
+  for (int i = 0; i < n; ++i) {
+    float s = g[i] + d[i];
+    float o = std::max(0.0f, s - g[i - 1] - d[i - 1]) * open[i - 1] +
+              std::max(0.0f, s - g[i + 1] - d[i + 1]) * open[i + 1] +
+              std::max(0.0f, s - g[i - stride] - d[i - stride]) * open[i - stride] +
+              std::max(0.0f, s - g[i + stride] - d[i + stride]) * open[i + stride];
+    scale[i] = std::min(1.0f, d[i] / std::max(o * LAVA_FLOW_RATE, 1e-12f));
+  }
+}
+
+// Applies the net flux to one row, writing the new depths to out. Flow to or
+// from a closed neighbour (wall, or a tile outside the update set) is
+// dropped on both sides, so lava is conserved. Returns the number of cells
+// that moved by more than LAVA_FLOW_EPSILON (an integer count, unlike a max,
+// keeps the loop vectorisable; so does __restrict, as out is written while
+// the other rows are read at +-stride).
+static int flux_row(const float *g, const float *d, const float *open,
+                    const float *scale, float *__restrict out, int n, int stride) {
+  int changed = 0;
+  for (int i = 0; i < n; ++i) {
+    float s = g[i] + d[i];
+    float dl = s - g[i - 1] - d[i - 1];
+    float dr = s - g[i + 1] - d[i + 1];
+    float du = s - g[i - stride] - d[i - stride];
+    float dd = s - g[i + stride] - d[i + stride];
+    float in = std::max(0.0f, -dl) * scale[i - 1] * open[i - 1] +
+               std::max(0.0f, -dr) * scale[i + 1] * open[i + 1] +
+               std::max(0.0f, -du) * scale[i - stride] * open[i - stride] +
+               std::max(0.0f, -dd) * scale[i + stride] * open[i + stride];
+    float lost = (std::max(0.0f, dl) * open[i - 1] + std::max(0.0f, dr) * open[i + 1] +
+                  std::max(0.0f, du) * open[i - stride] +
+                  std::max(0.0f, dd) * open[i + stride]) * scale[i];
+    float nd = d[i] + (in - lost) * LAVA_FLOW_RATE * open[i];
+    out[i] = nd;
+    changed += std::fabs(nd - d[i]) > LAVA_FLOW_EPSILON;
+  }
+  return changed;
+}
+
+void LavaFlowSim::init(const MapData &data) {
+  cells_x = (data.width + LAVA_FLOW_CELL - 1) / LAVA_FLOW_CELL;
+  cells_y = (data.height + LAVA_FLOW_CELL - 1) / LAVA_FLOW_CELL;
+  stride = cells_x + 2;
+  tiles_x = (cells_x + LAVA_FLOW_TILE - 1) / LAVA_FLOW_TILE;
+  tiles_y = (cells_y + LAVA_FLOW_TILE - 1) / LAVA_FLOW_TILE;
+  size_t cells = (size_t)stride * (cells_y + 2);
+  ground.assign(cells, 0.0f);
+  fluid.assign(cells, 0.0f);
+  open.assign(cells, 0.0f);
+  depth[0].assign(cells, 0.0f);
+  depth[1].assign(cells, 0.0f);
+  scale.assign(cells, 0.0f);
+  front = 0;
+  accumulator = 0.0f;
+  sources.clear();
+  tile_active.assign((size_t)tiles_x * tiles_y, 0);
+  tile_updated.assign(tile_active.size(), 0);
+  update_list.clear();
+
+  // A cell holds lava if any of its pixels do; its ground is the mean
+  // height under those pixels.
+  std::vector<int> count(cells, 0);
+  for (const auto &lava : data.lava_bodies)
+    for (const PixelRun &run : lava.runs)
+      for (int x = run.x0; x < run.x1; ++x) {
+        int c = cell_index(x, run.y);
+        ground[c] += data.basalt_height[run.y * data.width + x];
+        ++count[c];
+      }
+  for (size_t c = 0; c < cells; ++c)
+    if (count[c]) {
+      ground[c] /= count[c];
+      fluid[c] = 1.0f;
+    }
+
+  // Each body erupts from its highest cell.
+  const float pixels_per_cell = (float)(LAVA_FLOW_CELL * LAVA_FLOW_CELL);
+  for (const auto &lava : data.lava_bodies) {
+    int best = -1;
+    size_t pixels = 0;
+    for (const PixelRun &run : lava.runs) {
+      pixels += run.x1 - run.x0;
+      for (int x = run.x0; x < run.x1; x += LAVA_FLOW_CELL) {
+        int c = cell_index(x, run.y);
+        if (best < 0 || ground[c] > ground[best])
+          best = c;
+      }
+    }
+    if (best < 0)
+      continue;
+    float volume = LAVA_FLOW_FILL_DEPTH * std::max(1.0f, pixels / pixels_per_cell);
+    sources.push_back({best, volume / (LAVA_FLOW_ERUPTION_SECONDS / LAVA_FLOW_STEP),
+                       volume});
+    tile_active[tile_of(best)] = 1;
+  }
+  refresh_update_set();
+}
+
+int LavaFlowSim::cell_index(int x, int y) const {
+  return (y / LAVA_FLOW_CELL + 1) * stride + x / LAVA_FLOW_CELL + 1;
+}
+
+int LavaFlowSim::tile_of(int cell) const {
+  int cx = cell % stride - 1, cy = cell / stride - 1;
+  return (cy / LAVA_FLOW_TILE) * tiles_x + cx / LAVA_FLOW_TILE;
+}
+
+// Updated set = active tiles dilated by one. Tiles leaving it copy their
+// latest depths into the other buffer so both agree while they sleep.
+void LavaFlowSim::refresh_update_set() {
+  update_list.clear();
+  for (int ty = 0; ty < tiles_y; ++ty)
+    for (int tx = 0; tx < tiles_x; ++tx) {
+      bool want = false;
+      for (int dy = -1; dy <= 1 && !want; ++dy)
+        for (int dx = -1; dx <= 1; ++dx) {
+          int nx = tx + dx, ny = ty + dy;
+          if (nx >= 0 && ny >= 0 && nx < tiles_x && ny < tiles_y &&
+              tile_active[ny * tiles_x + nx]) {
+            want = true;
+            break;
+          }
+        }
+      int t = ty * tiles_x + tx;
+      if (want)
+        update_list.push_back(t);
+      if (want == (bool)tile_updated[t])
+        continue;
+      tile_updated[t] = want;
+      int x0 = tx * LAVA_FLOW_TILE, x1 = std::min(x0 + LAVA_FLOW_TILE, cells_x);
+      int y0 = ty * LAVA_FLOW_TILE, y1 = std::min(y0 + LAVA_FLOW_TILE, cells_y);
+      for (int y = y0; y < y1; ++y) {
+        size_t p = (size_t)(y + 1) * stride + x0 + 1;
+        size_t n = (size_t)(x1 - x0) * sizeof(float);
+        if (want) {
+          memcpy(&open[p], &fluid[p], n);
+        } else {
+          memset(&open[p], 0, n);
+          memcpy(&depth[front ^ 1][p], &depth[front][p], n);
+        }
+      }
+    }
+}
+
+bool LavaFlowSim::substep() {
+  if (update_list.empty())
+    return false;
+  const float *d = depth[front].data();
+  float *out = depth[front ^ 1].data();
+  auto tile_rows = [&](int t, auto &&row) {
+    int tx = t % tiles_x, ty = t / tiles_x;
+    int x0 = tx * LAVA_FLOW_TILE, x1 = std::min(x0 + LAVA_FLOW_TILE, cells_x);
+    int y0 = ty * LAVA_FLOW_TILE, y1 = std::min(y0 + LAVA_FLOW_TILE, cells_y);
+    for (int y = y0; y < y1; ++y)
+      row((size_t)(y + 1) * stride + x0 + 1, x1 - x0);
+  };
+  // A few tiles are cheaper to run inline than to hand to the workers.
+  int update_count = (int)update_list.size();
+  auto for_each_update = [&](const std::function<void(int)> &fn) {
+    if (update_count < 2 * parallel_worker_count())
+      for (int i = 0; i < update_count; ++i)
+        fn(i);
+    else
+      parallel_for(update_count, fn);
+  };
+
+  for_each_update([&](int i) {
+    tile_rows(update_list[i], [&](size_t p, int n) {
+      outflow_row(&ground[p], &d[p], &open[p], &scale[p], n, stride);
+    });
+  });
+  std::vector<int> changed(update_list.size(), 0);
+  for_each_update([&](int i) {
+    tile_rows(update_list[i], [&](size_t p, int n) {
+      changed[i] += flux_row(&ground[p], &d[p], &open[p], &scale[p], &out[p], n, stride);
+    });
+  });
+
+  std::fill(tile_active.begin(), tile_active.end(), 0);
+  bool moved = false;
+  for (size_t i = 0; i < update_list.size(); ++i)
+    if (changed[i]) {
+      tile_active[update_list[i]] = 1;
+      moved = true;
+    }
+  // Erupting sources keep their tile awake, so it is always updated here.
+  for (Source &src : sources) {
+    if (src.remaining <= 0.0f)
+      continue;
+    float add = std::min(src.rate, src.remaining);
+    out[src.cell] += add;
+    src.remaining -= add;
+    tile_active[tile_of(src.cell)] = 1;
+    moved = true;
+  }
+  front ^= 1;
+  refresh_update_set();
+  return moved;
+}
+
+bool LavaFlowSim::step(float dt) {
+  accumulator += dt;
+  int steps = (int)(accumulator / LAVA_FLOW_STEP);
+  accumulator -= steps * LAVA_FLOW_STEP;
+  if (steps > LAVA_FLOW_MAX_SUBSTEPS) {
+    // Falling behind: drop the backlog rather than spiral.
+    steps = LAVA_FLOW_MAX_SUBSTEPS;
+    accumulator = 0.0f;
+  }
+  bool moved = false;
+  for (int i = 0; i < steps; ++i)
+    moved |= substep();
+  return moved;
+}
+
+float LavaFlowSim::depth_at(float x, float y) const {
+  // Bilinear between cell centres; the padding border reads as dry.
+  float u = x / LAVA_FLOW_CELL + 0.5f, v = y / LAVA_FLOW_CELL + 0.5f;
+  if (depth[front].empty() ||
+      !(u >= 0.0f && v >= 0.0f && u < cells_x + 1 && v < cells_y + 1))
+    return 0.0f;
+  int cx = (int)u, cy = (int)v;
+  float fx = u - cx, fy = v - cy;
+  const float *d = depth[front].data() + (size_t)cy * stride + cx;
+  float top = d[0] + (d[1] - d[0]) * fx;
+  float bottom = d[stride] + (d[stride + 1] - d[stride]) * fx;
+  return std::min(top + (bottom - top) * fy, Config::LAVA_FLOW_MAX_RISE);
+}
+
+double LavaFlowSim::total_depth() const {
+  double sum = 0.0;
+  for (float v : depth[front])
+    sum += v;
+  return sum;
+}
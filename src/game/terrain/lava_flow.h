@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct MapData;
+
+// Cellular-automaton lava flow over basalt_height, confined to lava bodies.
+// Each body erupts a fixed volume from its highest cell, which runs
+// downhill and pools until it settles. Cells are LAVA_FLOW_CELL pixels
+// square; the grid is processed in LAVA_FLOW_TILE-square tiles and only
+// tiles that changed in the last step, plus their neighbours, are updated,
+// so a settled map costs nothing per step.
+struct LavaFlowSim {
+  int cells_x = 0, cells_y = 0;
+  int stride = 0; // padded row length (cells_x + 2)
+  int tiles_x = 0, tiles_y = 0;
+
+  // Padded by a one-cell border so neighbour reads need no bounds checks.
+  std::vector<float> ground;   // mean basalt_height of the cell's lava
+  std::vector<float> fluid;    // 1 for cells holding lava, 0 for walls
+  std::vector<float> open;     // fluid, and 0 outside the updated tiles
+  std::vector<float> depth[2]; // double-buffered lava depth
+  std::vector<float> scale;    // per-step outflow limiter
+  int front = 0;
+
+  struct Source {
+    int cell;        // padded cell index
+    float rate;      // depth added per step
+    float remaining; // depth still to erupt
+  };
+  std::vector<Source> sources;
+  std::vector<uint8_t> tile_active;  // changed in the last step
+  std::vector<uint8_t> tile_updated; // active or next to an active tile
+  std::vector<int> update_list;
+  float accumulator = 0.0f;
+
+  void init(const MapData &data);
+  // Advances by dt seconds in fixed substeps. Returns true if any depth
+  // changed, i.e. the lava surface needs refreshing.
+  bool step(float dt);
+
+  // Depth under map pixel (x, y), at most Config::LAVA_FLOW_MAX_RISE; 0 off
+  // the map.
+  float depth_at(float x, float y) const;
+  int updated_tile_count() const { return (int)update_list.size(); }
+  double total_depth() const;
+
+private:
+  bool substep();
+  void refresh_update_set();
+  int cell_index(int x, int y) const; // cell under map pixel (x, y)
+  int tile_of(int cell) const;
+};
@@ -0,0 +1,169 @@
+#include "terrain/lava_lights.h"
+#include "terrain/map_data.h"
+#include "config.h"
+#include "core/parallel.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+struct LavaSample {
+  float x, y, z; // pixels; z is the body's lava height
+  float weight;  // lava pixels the sample stands for
+};
+
+struct LightCluster {
+  double sx = 0, sy = 0, sz = 0, w = 0;
+};
+
+// Lloyd iterations after the grid seeding; the seeds are already close, so
+// a few passes settle the centroids.
+constexpr int LAVA_LIGHT_ITERATIONS = 4;
+// Radius of a light over a single sample, in world units; a cluster adds
+// twice its RMS spread on top.
+constexpr float LAVA_LIGHT_MIN_RADIUS = 8.0f;
+
+std::vector<GpuPointLight> place_lava_lights(const MapData &data, int budget) {
+  std::vector<GpuPointLight> lights;
+  if (budget <= 0) return lights;
+
+  // Lattice samples per body. A body too small to hold a lattice point
+  // still gets one sample at the middle of its first run.
+  const int step = (int)Config::HEX_SIZE;
+  const float lattice_weight = (float)(step * step);
+  std::vector<LavaSample> samples;
+  for (const auto &lava : data.lava_bodies) {
+    size_t first = samples.size();
+    size_t pixels = 0;
+    for (const PixelRun &run : lava.runs) {
+      pixels += run.x1 - run.x0;
+      if (run.y % step)
+        continue;
+      for (int x = (run.x0 + step - 1) / step * step; x < run.x1; x += step)
+        samples.push_back({(float)x, (float)run.y, lava.height, lattice_weight});
+    }
+    if (samples.size() == first && !lava.runs.empty()) {
+      const PixelRun &run = lava.runs.front();
+      samples.push_back({(run.x0 + run.x1) * 0.5f, (float)run.y, lava.height,
+                         (float)pixels});
+    }
+  }
+  if (samples.empty()) return lights;
+
+  // Seeds: merge samples into square cells, using the smallest cell whose
+  // occupied count fits the budget (binary search; a cell spanning the
+  // whole map always fits).
+  std::vector<uint64_t> keys(samples.size()), occupied;
+  auto occupy = [&](int cell) {
+    for (size_t i = 0; i < samples.size(); ++i)
+      keys[i] = (uint64_t)(uint32_t)((int)samples[i].y / cell) << 32 |
+                (uint32_t)((int)samples[i].x / cell);
+    occupied = keys;
+    std::sort(occupied.begin(), occupied.end());
+    occupied.erase(std::unique(occupied.begin(), occupied.end()), occupied.end());
+    return (int)occupied.size() <= budget;
+  };
+  int lo = 1, hi = std::max(data.width, data.height) + 1;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (occupy(mid))
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  occupy(hi);
+  std::vector<LightCluster> clusters(occupied.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    size_t c = std::lower_bound(occupied.begin(), occupied.end(), keys[i]) - occupied.begin();
+    const LavaSample &s = samples[i];
+    clusters[c].sx += s.x * s.weight;
+    clusters[c].sy += s.y * s.weight;
+    clusters[c].w += s.weight;
+  }
+
+  std::vector<float> cx(clusters.size()), cy(clusters.size());
+  std::vector<int> assign(samples.size());
+  auto update_centroids = [&] {
+    for (size_t c = 0; c < clusters.size(); ++c) {
+      if (clusters[c].w <= 0) continue; // emptied cluster keeps its centroid
+      cx[c] = (float)(clusters[c].sx / clusters[c].w);
+      cy[c] = (float)(clusters[c].sy / clusters[c].w);
+    }
+  };
+  update_centroids();
+
+  // Assignment is independent per sample, so it runs in parallel bands;
+  // the weighted sums are then gathered serially in sample order.
+  constexpr int BAND = 1024;
+  int bands = (int)((samples.size() + BAND - 1) / BAND);
+  for (int iter = 0; iter < LAVA_LIGHT_ITERATIONS; ++iter) {
+    parallel_for(bands, [&](int b) {
+      size_t end = std::min(samples.size(), (size_t)(b + 1) * BAND);
+      for (size_t i = (size_t)b * BAND; i < end; ++i) {
+        float best = FLT_MAX;
+        for (size_t c = 0; c < clusters.size(); ++c) {
+          float dx = samples[i].x - cx[c], dy = samples[i].y - cy[c];
+          float d = dx * dx + dy * dy;
+          if (d < best) {
+            best = d;
+            assign[i] = (int)c;
+          }
+        }
+      }
+    });
+    clusters.assign(clusters.size(), {});
+    for (size_t i = 0; i < samples.size(); ++i) {
+      LightCluster &k = clusters[assign[i]];
+      const LavaSample &s = samples[i];
+      k.sx += s.x * s.weight;
+      k.sy += s.y * s.weight;
+      k.w += s.weight;
+    }
+    update_centroids();
+  }
+
+  // Per cluster: mean height, RMS spread and the member nearest the
+  // centroid, which keeps the light over lava even for curved rivers.
+  std::vector<double> spread(clusters.size(), 0.0);
+  std::vector<float> nearest(clusters.size(), FLT_MAX);
+  std::vector<int> anchor(clusters.size(), -1);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    int c = assign[i];
+    const LavaSample &s = samples[i];
+    float dx = s.x - cx[c], dy = s.y - cy[c];
+    float d = dx * dx + dy * dy;
+    clusters[c].sz += s.z * s.weight;
+    spread[c] += d * s.weight;
+    if (d < nearest[c]) {
+      nearest[c] = d;
+      anchor[c] = (int)i;
+    }
+  }
+
+  double total = 0;
+  int used = 0;
+  for (const auto &k : clusters)
+    if (k.w > 0) {
+      total += k.w;
+      ++used;
+    }
+  const double mean_weight = total / std::max(used, 1);
+
+  const float inv = 1.0f / Config::HEX_SIZE;
+  for (size_t c = 0; c < clusters.size(); ++c) {
+    if (anchor[c] < 0 || clusters[c].w <= 0) continue;
+    const LavaSample &at = samples[anchor[c]];
+    float rms = (float)std::sqrt(spread[c] / clusters[c].w) * inv;
+    float gain = (float)std::sqrt(clusters[c].w / mean_weight);
+    GpuPointLight pl;
+    pl.pos_x     = at.x * inv;
+    pl.pos_y     = at.y * inv;
+    pl.pos_z     = (float)(clusters[c].sz / clusters[c].w) + 1.0f;
+    pl.radius    = std::min(LAVA_LIGHT_MIN_RADIUS + 2.0f * rms, Config::LAVA_GLOW_RADIUS);
+    pl.color_r   = 1.0f;
+    pl.color_g   = 0.35f;
+    pl.color_b   = 0.05f;
+    pl.intensity = Config::LAVA_GLOW_INTENSITY * std::clamp(gain, 0.5f, 2.0f);
+    lights.push_back(pl);
+  }
+  return lights;
+}
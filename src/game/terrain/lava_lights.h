@@ -0,0 +1,12 @@
+#pragma once
+#include "terrain/terrain_mesh.h"
+#include <vector>
+
+struct MapData;
+
+// Places at most `budget` point lights over the lava bodies of `data`: lava
+// is sampled on a HEX_SIZE lattice, grid-merged into seed clusters and
+// refined with a few weighted k-means passes. Each light sits on the lava
+// sample nearest its cluster centroid, in world units, with radius and
+// intensity grown from the cluster's spread and sample count.
+std::vector<GpuPointLight> place_lava_lights(const MapData &data, int budget);
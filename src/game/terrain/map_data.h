@@ -1,5 +1,6 @@
 #pragma once
 #include "terrain/contour.h"
+#include "terrain/distance_field.h"
 #include "terrain/hex.h"
 #include "terrain/lava.h"
 #include <cstdint>
@@ -15,6 +16,13 @@ struct MapData {
   int width = 0;
   int height = 0;
 
+  // Move-only: body run spans point into body_runs.
+  MapData() = default;
+  MapData(const MapData &) = delete;
+  MapData &operator=(const MapData &) = delete;
+  MapData(MapData &&) = default;
+  MapData &operator=(MapData &&) = default;
+
 
   std::vector<float> elevation;
   std::vector<float> river_mask;
@@ -30,8 +38,11 @@ struct MapData {
 
   std::vector<HexColumn> columns;
   std::vector<int16_t> terrain_map;
+  std::vector<float> lava_distance; // pixels to the nearest TERRAIN_LAVA pixel
   std::vector<LavaBody> lava_bodies;
   std::vector<LavaBody> void_bodies;
+  RegionRuns body_runs;              // backs lava_bodies/void_bodies run spans
+  std::vector<uint32_t> body_labels; // see BODY_LABEL_VOID
   std::vector<Line> contour_lines;
   std::vector<int> band_map;
 
@@ -48,9 +59,12 @@ struct MapData {
     liquid_mask.resize(n);
     basalt_height.resize(n);
     terrain_map.assign(n, 0);
+    lava_distance.assign(n, DISTANCE_FIELD_FAR);
     columns.clear();
     lava_bodies.clear();
     void_bodies.clear();
+    body_runs.clear();
+    body_labels.assign(n, 0);
     contour_lines.clear();
     band_map.resize(n);
   }
@@ -0,0 +1,163 @@
+#include "terrain/morphology.h"
+
+// Row r shifted so that bit x holds pixel x + 1 (east neighbour) or
+// pixel x - 1 (west neighbour). Padding bits are zero, so nothing enters
+// from past the right edge; west() can push a pixel into the padding and
+// callers mask the last word.
+static inline uint64_t east(const uint64_t *r, int k, int stride) {
+  return (r[k] >> 1) | (k + 1 < stride ? r[k + 1] << 63 : 0);
+}
+
+static inline uint64_t west(const uint64_t *r, int k) {
+  return (r[k] << 1) | (k > 0 ? r[k - 1] >> 63 : 0);
+}
+
+void dilate4(const Bitmap &src, Bitmap &dst) {
+  dst.reset(src.width, src.height);
+  const int stride = src.stride;
+  const uint64_t tail = src.tail_mask();
+  for (int y = 0; y < src.height; ++y) {
+    const uint64_t *c = src.row(y);
+    const uint64_t *n = y > 0 ? src.row(y - 1) : nullptr;
+    const uint64_t *s = y + 1 < src.height ? src.row(y + 1) : nullptr;
+    uint64_t *out = dst.row(y);
+    for (int k = 0; k < stride; ++k) {
+      uint64_t v = c[k] | east(c, k, stride) | west(c, k);
+      if (n) v |= n[k];
+      if (s) v |= s[k];
+      out[k] = v;
+    }
+    out[stride - 1] &= tail;
+  }
+}
+
+void erode4(const Bitmap &src, Bitmap &dst) {
+  dst.reset(src.width, src.height);
+  const int stride = src.stride;
+  const uint64_t tail = src.tail_mask();
+  // Border rows have an unset neighbour outside the image.
+  for (int y = 1; y + 1 < src.height; ++y) {
+    const uint64_t *c = src.row(y);
+    const uint64_t *n = src.row(y - 1);
+    const uint64_t *s = src.row(y + 1);
+    uint64_t *out = dst.row(y);
+    for (int k = 0; k < stride; ++k)
+      out[k] = c[k] & n[k] & s[k] & east(c, k, stride) & west(c, k);
+    out[stride - 1] &= tail;
+  }
+}
+
+void close4(const Bitmap &src, Bitmap &dst) {
+  Bitmap grown;
+  dilate4(src, grown);
+  erode4(grown, dst);
+  // Erosion treats the outside as unset, which would eat set pixels on the
+  // image border; a closing never removes pixels.
+  for (size_t i = 0; i < dst.words.size(); ++i)
+    dst.words[i] |= src.words[i];
+}
+
+void fill_holes(const Bitmap &src, Bitmap &dst) {
+  const int w = src.width, h = src.height, stride = src.stride;
+  const uint64_t tail = src.tail_mask();
+  if (w == 0 || h == 0) {
+    dst = src;
+    return;
+  }
+
+  // Background reachable from the border, grown one sweep at a time: each
+  // sweep pulls reach in from the previous row and then spreads it along
+  // the row with word shifts.
+  Bitmap bg, reach;
+  bg.reset(w, h);
+  reach.reset(w, h);
+  for (size_t i = 0; i < src.words.size(); ++i)
+    bg.words[i] = ~src.words[i];
+  for (int y = 0; y < h; ++y)
+    bg.row(y)[stride - 1] &= tail;
+
+  for (int y = 0; y < h; ++y) {
+    const uint64_t *b = bg.row(y);
+    uint64_t *r = reach.row(y);
+    if (y == 0 || y == h - 1) {
+      for (int k = 0; k < stride; ++k)
+        r[k] = b[k];
+    } else {
+      r[0] |= b[0] & 1;
+      int last = w - 1;
+      r[last >> 6] |= b[last >> 6] & (uint64_t(1) << (last & 63));
+    }
+  }
+
+  auto spread_row = [&](int y, const uint64_t *from) {
+    const uint64_t *b = bg.row(y);
+    uint64_t *r = reach.row(y);
+    bool changed = false;
+    if (from) {
+      for (int k = 0; k < stride; ++k) {
+        uint64_t v = r[k] | (from[k] & b[k]);
+        changed |= v != r[k];
+        r[k] = v;
+      }
+    }
+    for (bool again = true; again;) {
+      again = false;
+      for (int k = 0; k < stride; ++k) {
+        uint64_t v = r[k] | ((east(r, k, stride) | west(r, k)) & b[k]);
+        if (v != r[k]) {
+          r[k] = v;
+          again = true;
+          changed = true;
+        }
+      }
+    }
+    return changed;
+  };
+
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (int y = 0; y < h; ++y)
+      changed |= spread_row(y, y > 0 ? reach.row(y - 1) : nullptr);
+    for (int y = h - 1; y >= 0; --y)
+      changed |= spread_row(y, y + 1 < h ? reach.row(y + 1) : nullptr);
+  }
+
+  dst.reset(w, h);
+  for (int y = 0; y < h; ++y) {
+    const uint64_t *r = reach.row(y);
+    uint64_t *out = dst.row(y);
+    for (int k = 0; k < stride; ++k)
+      out[k] = ~r[k];
+    out[stride - 1] &= tail;
+  }
+}
+
+void fill_notches(const Bitmap &src, Bitmap &dst) {
+  dst = src;
+  const int stride = dst.stride;
+  const uint64_t tail = dst.tail_mask();
+
+  // In-place sweeps reach the same fixpoint as parallel updates (the rule
+  // only ever adds pixels) in fewer passes.
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (int y = 0; y < dst.height; ++y) {
+      uint64_t *c = dst.row(y);
+      const uint64_t *n = y > 0 ? dst.row(y - 1) : nullptr;
+      const uint64_t *s = y + 1 < dst.height ? dst.row(y + 1) : nullptr;
+      for (int k = 0; k < stride; ++k) {
+        uint64_t nv = n ? n[k] : 0;
+        uint64_t sv = s ? s[k] : 0;
+        uint64_t ev = east(c, k, stride), wv = west(c, k);
+        uint64_t three = (nv & sv & (ev | wv)) | (ev & wv & (nv | sv));
+        uint64_t add = three & ~c[k];
+        if (k == stride - 1)
+          add &= tail;
+        if (add) {
+          c[k] |= add;
+          changed = true;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Binary image packed 64 pixels per word; bit b of word k in a row is pixel
+// x = 64 * k + b. Bits past `width` in the last word of a row stay zero.
+struct Bitmap {
+  int width = 0, height = 0;
+  int stride = 0; // words per row
+  std::vector<uint64_t> words;
+
+  // Resizes and clears.
+  void reset(int w, int h) {
+    width = w;
+    height = h;
+    stride = (w + 63) / 64;
+    words.assign((size_t)stride * h, 0);
+  }
+
+  uint64_t *row(int y) { return words.data() + (size_t)y * stride; }
+  const uint64_t *row(int y) const { return words.data() + (size_t)y * stride; }
+
+  bool test(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1; }
+  void set(int x, int y) { row(y)[x >> 6] |= uint64_t(1) << (x & 63); }
+
+  // Valid bits of the last word in each row.
+  uint64_t tail_mask() const {
+    int r = width & 63;
+    return r ? (uint64_t(1) << r) - 1 : ~uint64_t(0);
+  }
+
+  // Calls fn(y, x0, x1) for every maximal run of set pixels [x0, x1) in
+  // raster order.
+  template <typename Fn> void for_each_run(Fn &&fn) const {
+    for (int y = 0; y < height; ++y) {
+      const uint64_t *r = row(y);
+      int start = -1;
+      for (int k = 0; k < stride; ++k) {
+        // Alternately skip to the next set bit (run start) and the next
+        // clear bit (run end) within the word.
+        for (int bit = 0; bit < 64;) {
+          uint64_t rest = (start < 0 ? r[k] : ~r[k]) >> bit;
+          if (!rest)
+            break;
+          bit += std::countr_zero(rest);
+          if (start < 0) {
+            start = k * 64 + bit;
+          } else {
+            fn(y, start, k * 64 + bit);
+            start = -1;
+          }
+        }
+      }
+      if (start >= 0)
+        fn(y, start, width);
+    }
+  }
+
+  // Calls fn(x, y) for every set pixel in raster order.
+  template <typename Fn> void for_each_set(Fn &&fn) const {
+    for (int y = 0; y < height; ++y) {
+      const uint64_t *r = row(y);
+      for (int k = 0; k < stride; ++k)
+        for (uint64_t w = r[k]; w; w &= w - 1)
+          fn(k * 64 + std::countr_zero(w), y);
+    }
+  }
+};
+
+// 4-neighbour dilation; pixels outside the image count as unset.
+void dilate4(const Bitmap &src, Bitmap &dst);
+// 4-neighbour erosion; pixels outside the image count as unset.
+void erode4(const Bitmap &src, Bitmap &dst);
+// dilate4 followed by erode4.
+void close4(const Bitmap &src, Bitmap &dst);
+// Sets every unset pixel not 4-connected to the image border.
+void fill_holes(const Bitmap &src, Bitmap &dst);
+// Repeatedly sets unset pixels with at least three set 4-neighbours until
+// nothing changes, closing one-pixel notches and pinholes.
+void fill_notches(const Bitmap &src, Bitmap &dst);
@@ -7,6 +7,7 @@ struct CompositionParams {
   float river_elevation_max = 0.35f;
   float void_chance = 0.3f;
   int terrace_levels = 8;
+  bool smooth_lava_shore = false;
 
   int min_region_size = 10000;
 };
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Pixel index lists of many regions in one allocation, CSR style: region i
+// owns indices[offsets[i], offsets[i + 1]). Regions are appended one at a
+// time with push() and close_region()/discard_region().
+//
+// Region structs (Plateau, ChannelRegion) hold spans into the
+// store. Builders reserve the index array from a counting pass and hand out
+// spans only once the store is complete; after that the store must not be
+// modified or copied while the spans are in use (moving it is fine).
+struct RegionPixels {
+  std::vector<uint32_t> offsets{0};
+  std::vector<int> indices;
+
+  size_t size() const { return offsets.size() - 1; }
+
+  std::span<const int> operator[](size_t i) const {
+    return {indices.data() + offsets[i], offsets[i + 1] - offsets[i]};
+  }
+
+  void clear() {
+    offsets.assign(1, 0);
+    indices.clear();
+  }
+
+  void reserve(size_t regions, size_t pixels) {
+    offsets.reserve(regions + 1);
+    indices.reserve(pixels);
+  }
+
+  void push(int idx) { indices.push_back(idx); }
+
+  // Pixels pushed since the last close_region()/discard_region().
+  std::span<const int> open_region() const {
+    return {indices.data() + offsets.back(), indices.size() - offsets.back()};
+  }
+
+  // Ends the open region and returns its id.
+  uint32_t close_region() {
+    offsets.push_back((uint32_t)indices.size());
+    return (uint32_t)offsets.size() - 2;
+  }
+
+  void discard_region() { indices.resize(offsets.back()); }
+};
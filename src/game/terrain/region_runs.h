@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Pixels [x0, x1) of row y.
+struct PixelRun {
+  int y, x0, x1;
+};
+
+// Row runs of many regions in one allocation, laid out like RegionPixels:
+// region i owns runs[offsets[i], offsets[i + 1]), sorted by row then column.
+// The same span rules apply: hand out spans only once the store is built.
+struct RegionRuns {
+  std::vector<uint32_t> offsets{0};
+  std::vector<PixelRun> runs;
+
+  size_t size() const { return offsets.size() - 1; }
+
+  std::span<const PixelRun> operator[](size_t i) const {
+    return {runs.data() + offsets[i], offsets[i + 1] - offsets[i]};
+  }
+
+  void clear() {
+    offsets.assign(1, 0);
+    runs.clear();
+  }
+
+  void reserve(size_t regions, size_t run_count) {
+    offsets.reserve(regions + 1);
+    runs.reserve(run_count);
+  }
+
+  void push(int y, int x0, int x1) { runs.push_back({y, x0, x1}); }
+
+  // Runs pushed since the last close_region()/discard_region().
+  std::span<const PixelRun> open_region() const {
+    return {runs.data() + offsets.back(), runs.size() - offsets.back()};
+  }
+
+  // Ends the open region and returns its id.
+  uint32_t close_region() {
+    offsets.push_back((uint32_t)runs.size());
+    return (uint32_t)offsets.size() - 2;
+  }
+
+  void discard_region() { runs.resize(offsets.back()); }
+};
+
+inline size_t run_pixel_count(std::span<const PixelRun> runs) {
+  size_t n = 0;
+  for (const auto &r : runs)
+    n += r.x1 - r.x0;
+  return n;
+}
+
+// Calls fn(idx) for each pixel, idx = y * width + x, in raster order.
+template <typename Fn>
+void for_each_run_pixel(std::span<const PixelRun> runs, int width, Fn &&fn) {
+  for (const auto &r : runs)
+    for (int idx = r.y * width + r.x0, end = r.y * width + r.x1; idx < end; ++idx)
+      fn(idx);
+}
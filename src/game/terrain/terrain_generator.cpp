@@ -14,7 +14,7 @@ TerrainGenerator::generate(std::span<const float> heightmap,
   data.terrain_map.assign(width * height, TERRAIN_EMPTY);
 
   data.plateaus = detect_plateaus(band_map, heightmap, width, height,
-                                  data.terrain_map);
+                                  data.terrain_map, data.plateau_pixels);
   SDL_Log("TerrainGenerator: Found %zu plateaus", data.plateaus.size());
 
   data.columns = generate_basalt_columns(heightmap, width, height,
@@ -24,24 +24,28 @@ TerrainGenerator::generate(std::span<const float> heightmap,
   SDL_Log("TerrainGenerator: Generated %zu columns on %zu plateaus",
           data.columns.size(), data.plateaus_with_columns.size());
 
-  auto channel_regions =
-      extract_channel_spaces(data.terrain_map, width, height, heightmap);
+  RegionPixels channel_pixels;
+  auto channel_regions = extract_channel_spaces(data.terrain_map, width, height,
+                                                heightmap, channel_pixels);
   SDL_Log("TerrainGenerator: Found %zu channel regions",
           channel_regions.size());
 
-  auto lava_channels =
-      filter_lava_channels(channel_regions, heightmap, width, height);
+  RegionPixels lava_channel_pixels;
+  auto lava_channels = filter_lava_channels(std::move(channel_regions), heightmap,
+                                            width, height, lava_channel_pixels);
   SDL_Log("TerrainGenerator: Selected %zu lava channels",
           lava_channels.size());
-  data.lava_bodies =
-      channels_to_lava_bodies(lava_channels, heightmap, width, height);
+  RegionPixels trimmed_channel_pixels;
+  lava_channels = subdivide_large_regions(std::move(lava_channels), data.columns,
+                                          width, height, trimmed_channel_pixels);
+  data.lava_bodies = channels_to_lava_bodies(lava_channels, heightmap, width,
+                                             height, data.lava_runs);
   SDL_Log("TerrainGenerator: Created %zu lava bodies",
           data.lava_bodies.size());
 
   for (const auto& wb : data.lava_bodies)
-    for (int idx : wb.pixels)
-      if (idx >= 0 && idx < width * height)
-        data.terrain_map[idx] = TERRAIN_LAVA;
+    for_each_run_pixel(wb.runs, width,
+                       [&](int idx) { data.terrain_map[idx] = TERRAIN_LAVA; });
 
   return data;
 }
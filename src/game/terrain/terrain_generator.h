@@ -15,8 +15,17 @@ public:
     std::vector<Plateau> plateaus;
     std::vector<HexColumn> columns;
     std::vector<LavaBody> lava_bodies;
+    RegionPixels plateau_pixels;
+    RegionRuns lava_runs;
     std::vector<int> plateaus_with_columns;
     std::vector<int16_t> terrain_map;
+
+    // Move-only: plateau/lava spans point into plateau_pixels/lava_runs.
+    TerrainData() = default;
+    TerrainData(const TerrainData &) = delete;
+    TerrainData &operator=(const TerrainData &) = delete;
+    TerrainData(TerrainData &&) = default;
+    TerrainData &operator=(TerrainData &&) = default;
   };
 
   static TerrainData generate(std::span<const float> heightmap,
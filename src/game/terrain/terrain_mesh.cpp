@@ -1,14 +1,17 @@
 #include "terrain/terrain_mesh.h"
 #include "game_state.h"
 #include "config.h"
+#include "core/parallel.h"
 #include "terrain/basalt.h"
 #include "terrain/hex.h"
 #include "terrain/lava.h"
+#include "terrain/lava_lights.h"
 #include "terrain/map_data.h"
 #include "terrain/palettes.h"
 #include "terrain/color.h"
 #include <SDL3/SDL.h>
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
 
 static void color_to_float(uint32_t c, float &r, float &g, float &b) {
@@ -17,29 +20,35 @@ static void color_to_float(uint32_t c, float &r, float &g, float &b) {
   b = (c         & 0xFF) / 255.0f;
 }
 
-static void add_hex_top(const Vec2 corners[6], float z,
-                        float cr, float cg, float cb, float sheen,
-                        TerrainMesh::RenderingLayer &layer) {
-  uint32_t base = (uint32_t)layer.vertices.size();
+// Writes a hex top (6 vertices, 12 indices) at verts/idx; base is the index
+// of verts[0] in the layer.
+static void write_hex_top(const Vec2 corners[6], float z,
+                          float cr, float cg, float cb, float sheen,
+                          BasaltVertex *verts, uint32_t *idx, uint32_t base) {
   for (int i = 0; i < 6; ++i) {
     float wx = corners[i].x / Config::HEX_SIZE;
     float wy = corners[i].y / Config::HEX_SIZE;
-    layer.vertices.push_back({wx, wy, z, cr, cg, cb, sheen, 0.0f, 0.0f, 1.0f});
+    verts[i] = {wx, wy, z, cr, cg, cb, sheen, 0.0f, 0.0f, 1.0f};
   }
   for (int i = 1; i <= 4; ++i) {
-    layer.indices.push_back(base);
-    layer.indices.push_back(base + i);
-    layer.indices.push_back(base + i + 1);
+    *idx++ = base;
+    *idx++ = base + i;
+    *idx++ = base + i + 1;
   }
 }
 
-static void add_side_face(const Vec2 &corner0, const Vec2 &corner1,
-                          float top_height, float bottom_height,
-                          float cr, float cg, float cb, float sheen,
-                          TerrainMesh::RenderingLayer &layer) {
-  if (top_height - bottom_height < 0.01f)
-    return;
+// Edge i of a column gets a side face if it is visible and drops far enough
+// to show. The count and fill passes must agree exactly.
+static bool has_side_face(const HexColumn &col, int i) {
+  return col.visible_edges[i] && col.height - (col.height - col.edge_drops[i]) >= 0.01f;
+}
 
+// Writes a side quad (4 vertices, 6 indices) at verts/idx; base is the index
+// of verts[0] in the layer.
+static void write_side_face(const Vec2 &corner0, const Vec2 &corner1,
+                            float top_height, float bottom_height,
+                            float cr, float cg, float cb, float sheen,
+                            BasaltVertex *verts, uint32_t *idx, uint32_t base) {
   float wx0 = corner0.x / Config::HEX_SIZE;
   float wy0 = corner0.y / Config::HEX_SIZE;
   float wx1 = corner1.x / Config::HEX_SIZE;
@@ -56,18 +65,129 @@ static void add_side_face(const Vec2 &corner0, const Vec2 &corner1,
 
   float side_sheen = sheen * 0.4f;
 
-  uint32_t base = (uint32_t)layer.vertices.size();
-  layer.vertices.push_back({wx0, wy0, top_height,    cr, cg, cb, side_sheen, nx, ny, 0.0f});
-  layer.vertices.push_back({wx1, wy1, top_height,    cr, cg, cb, side_sheen, nx, ny, 0.0f});
-  layer.vertices.push_back({wx1, wy1, bottom_height, cr, cg, cb, side_sheen, nx, ny, 0.0f});
-  layer.vertices.push_back({wx0, wy0, bottom_height, cr, cg, cb, side_sheen, nx, ny, 0.0f});
+  verts[0] = {wx0, wy0, top_height,    cr, cg, cb, side_sheen, nx, ny, 0.0f};
+  verts[1] = {wx1, wy1, top_height,    cr, cg, cb, side_sheen, nx, ny, 0.0f};
+  verts[2] = {wx1, wy1, bottom_height, cr, cg, cb, side_sheen, nx, ny, 0.0f};
+  verts[3] = {wx0, wy0, bottom_height, cr, cg, cb, side_sheen, nx, ny, 0.0f};
+
+  idx[0] = base;
+  idx[1] = base + 1;
+  idx[2] = base + 2;
+  idx[3] = base;
+  idx[4] = base + 2;
+  idx[5] = base + 3;
+}
+
+// Reorders the primitives in indices[begin..] (prim_size indices each) by the
+// tile their centroid falls in, so every tile is one contiguous range, and
+// grows the tile bounds by each primitive's vertices. z_below/z_above cover
+// vertex shader displacement and CPU-side raising of the vertices.
+template <typename V>
+static void sort_into_tiles(const std::vector<V> &verts, std::vector<uint32_t> &indices,
+                            size_t begin, int prim_size, float z_below, float z_above,
+                            TerrainMesh &mesh, TerrainMesh::IndexRange *ranges) {
+  const int tile_count = mesh.tiles_x * mesh.tiles_y;
+  const float inv_tile = 1.0f / Config::GEOMETRY_TILE_UNITS;
+  size_t prim_count = (indices.size() - begin) / prim_size;
+
+  std::vector<int> prim_tile(prim_count);
+  std::vector<uint32_t> offsets(tile_count + 1, 0);
+  for (size_t p = 0; p < prim_count; ++p) {
+    const uint32_t *idx = &indices[begin + p * prim_size];
+    float cx = 0.0f, cy = 0.0f;
+    for (int k = 0; k < prim_size; ++k) {
+      cx += verts[idx[k]].pos_x;
+      cy += verts[idx[k]].pos_y;
+    }
+    int tx = std::clamp((int)(cx / prim_size * inv_tile), 0, mesh.tiles_x - 1);
+    int ty = std::clamp((int)(cy / prim_size * inv_tile), 0, mesh.tiles_y - 1);
+    int t = ty * mesh.tiles_x + tx;
+    prim_tile[p] = t;
+    offsets[t + 1]++;
+
+    auto &b = mesh.tile_bounds[t];
+    for (int k = 0; k < prim_size; ++k) {
+      const V &v = verts[idx[k]];
+      b.min_x = std::min(b.min_x, v.pos_x);
+      b.max_x = std::max(b.max_x, v.pos_x);
+      b.min_y = std::min(b.min_y, v.pos_y);
+      b.max_y = std::max(b.max_y, v.pos_y);
+      b.min_z = std::min(b.min_z, v.pos_z - z_below);
+      b.max_z = std::max(b.max_z, v.pos_z + z_above);
+    }
+  }
+  for (int t = 0; t < tile_count; ++t)
+    offsets[t + 1] += offsets[t];
+
+  std::vector<uint32_t> sorted(prim_count * prim_size);
+  std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+  for (size_t p = 0; p < prim_count; ++p) {
+    uint32_t dst = cursor[prim_tile[p]]++ * prim_size;
+    for (int k = 0; k < prim_size; ++k)
+      sorted[dst + k] = indices[begin + p * prim_size + k];
+  }
+  std::copy(sorted.begin(), sorted.end(), indices.begin() + begin);
+
+  for (int t = 0; t < tile_count; ++t)
+    ranges[t] = {(uint32_t)(begin + offsets[t] * prim_size),
+                 (offsets[t + 1] - offsets[t]) * prim_size};
+}
+
+// Canonical unit prism: side faces 0-5 laid out like write_side_face, then
+// the top cap fanned like write_hex_top.
+static void build_hex_prism(std::vector<GpuHexPrismVertex> &verts,
+                            std::vector<uint32_t> &indices) {
+  verts.clear();
+  indices.clear();
+  verts.reserve(30);
+  indices.reserve(48);
+  for (int i = 0; i < 6; ++i) {
+    const Vec2 &a = HEX_UNIT_CORNERS[i];
+    const Vec2 &b = HEX_UNIT_CORNERS[(i + 1) % 6];
+    float edx = b.x - a.x, edy = b.y - a.y;
+    float nlen = std::sqrt(edx * edx + edy * edy);
+    float nx = edy / nlen, ny = -edx / nlen;
+    uint32_t base = (uint32_t)verts.size();
+    verts.push_back({a.x, a.y, 1.0f, (float)i, nx, ny, 0.0f});
+    verts.push_back({b.x, b.y, 1.0f, (float)i, nx, ny, 0.0f});
+    verts.push_back({b.x, b.y, 0.0f, (float)i, nx, ny, 0.0f});
+    verts.push_back({a.x, a.y, 0.0f, (float)i, nx, ny, 0.0f});
+    for (uint32_t k : {0u, 1u, 2u, 0u, 2u, 3u})
+      indices.push_back(base + k);
+  }
+  uint32_t base = (uint32_t)verts.size();
+  for (int i = 0; i < 6; ++i)
+    verts.push_back({HEX_UNIT_CORNERS[i].x, HEX_UNIT_CORNERS[i].y, 1.0f, 6.0f, 0.0f, 0.0f, 1.0f});
+  for (uint32_t i = 1; i <= 4; ++i)
+    for (uint32_t k : {0u, i, i + 1})
+      indices.push_back(base + k);
+}
+
+// Everything in a column's instance except its colour.
+static void fill_hex_instance(const HexColumn &col, GpuHexInstance &inst) {
+  inst.q = (int16_t)col.q;
+  inst.r = (int16_t)col.r;
+  inst.height = col.height;
+  inst.edge_mask = 0;
+  for (int i = 0; i < 6; ++i) {
+    inst.drops[i] = 0;
+    if (!has_side_face(col, i))
+      continue;
+    inst.edge_mask |= 1u << i;
+    // Rounded up, so the face reaches at least down to the neighbour's top.
+    float d = std::clamp(col.edge_drops[i] / Config::HEX_DROP_RANGE, 0.0f, 1.0f);
+    inst.drops[i] = (uint16_t)std::ceil(d * 65535.0f);
+  }
+}
 
-  layer.indices.push_back(base);
-  layer.indices.push_back(base + 1);
-  layer.indices.push_back(base + 2);
-  layer.indices.push_back(base);
-  layer.indices.push_back(base + 2);
-  layer.indices.push_back(base + 3);
+void recolor_hex_instances(std::span<GpuHexInstance> instances,
+                           std::span<const HexColumn> columns, const Palette &palette) {
+  for (size_t c = 0; c < instances.size() && c < columns.size(); ++c) {
+    uint32_t color = organic_color(columns[c].base_height, columns[c].q, columns[c].r, palette);
+    instances[c].color_r = (color >> 16) & 0xFF;
+    instances[c].color_g = (color >>  8) & 0xFF;
+    instances[c].color_b =  color        & 0xFF;
+  }
 }
 
 TerrainMesh build_terrain_mesh(const TerrainState &terrain, const MapData &map_data,
@@ -84,42 +204,98 @@ TerrainMesh build_terrain_mesh(const TerrainState &terrain, const MapData &map_d
 
   const Palette &palette = PALETTES[terrain.current_palette];
 
-  mesh.basalt_layers.resize(2);
+  // Count pass: side faces per column, prefix-summed into each column's
+  // first side quad, so the fill pass writes straight into exact offsets.
+  std::vector<uint32_t> side_first(columns.size() + 1, 0);
+  for (size_t c = 0; c < columns.size(); ++c) {
+    uint32_t sides = 0;
+    for (int i = 0; i < 6; ++i)
+      sides += has_side_face(columns[c], i);
+    side_first[c + 1] = side_first[c] + sides;
+  }
+  const size_t side_quads = side_first.back();
+  mesh.baked_basalt_bytes = side_quads * (4 * sizeof(BasaltVertex) + 6 * sizeof(uint32_t)) +
+                            columns.size() * (6 * sizeof(BasaltVertex) + 12 * sizeof(uint32_t));
 
-  for (const auto &col : columns) {
-    uint32_t color = organic_color(col.base_height, col.q, col.r, palette);
-    float cr, cg, cb;
-    color_to_float(color, cr, cg, cb);
+  build_hex_prism(mesh.hex_prism_vertices, mesh.hex_prism_indices);
+  mesh.instanced_basalt_bytes = columns.size() * sizeof(GpuHexInstance) +
+                                mesh.hex_prism_vertices.size() * sizeof(GpuHexPrismVertex) +
+                                mesh.hex_prism_indices.size() * sizeof(uint32_t);
 
-    Vec2 corners[6];
-    get_hex_corners(col.q, col.r, Config::HEX_SIZE, corners);
+  const bool baked = !terrain.instanced_columns;
+  mesh.basalt_layers.resize(2);
+  auto &side_layer = mesh.basalt_layers[0];
+  auto &top_layer  = mesh.basalt_layers[1];
+  if (!baked) {
+    mesh.hex_instances.resize(columns.size());
+  } else {
+    side_layer.vertices.resize(side_quads * 4);
+    side_layer.indices.resize(side_quads * 6);
+    top_layer.vertices.resize(columns.size() * 6);
+    top_layer.indices.resize(columns.size() * 12);
+  }
 
-    for (int i = 0; i < 6; ++i) {
-      if (col.visible_edges[i]) {
-        int next = (i + 1) % 6;
+  // Fill pass: one instance per column, or when baked, colour and corners
+  // once per column with sides and top written together.
+  constexpr int COLUMNS_PER_TASK = 1024;
+  const float hex = Config::HEX_SIZE;
+  parallel_for((int)((columns.size() + COLUMNS_PER_TASK - 1) / COLUMNS_PER_TASK), [&](int task) {
+    size_t c0 = (size_t)task * COLUMNS_PER_TASK;
+    size_t c1 = std::min(c0 + COLUMNS_PER_TASK, columns.size());
+    if (!baked) {
+      recolor_hex_instances(std::span(mesh.hex_instances).subspan(c0, c1 - c0),
+                            std::span(columns).subspan(c0, c1 - c0), palette);
+      for (size_t c = c0; c < c1; ++c)
+        fill_hex_instance(columns[c], mesh.hex_instances[c]);
+      return;
+    }
+    for (size_t c = c0; c < c1; ++c) {
+      const HexColumn &col = columns[c];
+      uint32_t color = organic_color(col.base_height, col.q, col.r, palette);
+      float cr, cg, cb;
+      color_to_float(color, cr, cg, cb);
+
+      float cx, cy;
+      hex_to_pixel(col.q, col.r, hex, cx, cy);
+      Vec2 corners[6];
+      for (int i = 0; i < 6; ++i)
+        corners[i] = {cx + hex * HEX_UNIT_CORNERS[i].x, cy + hex * HEX_UNIT_CORNERS[i].y};
+
+      uint32_t quad = side_first[c];
+      for (int i = 0; i < 6; ++i) {
+        if (!has_side_face(col, i))
+          continue;
         float neighbor_height = col.height - col.edge_drops[i];
-        add_side_face(corners[i], corners[next], col.height, neighbor_height,
-                      cr, cg, cb, 1.0f, mesh.basalt_layers[0]);
+        write_side_face(corners[i], corners[(i + 1) % 6], col.height, neighbor_height,
+                        cr, cg, cb, 1.0f, &side_layer.vertices[(size_t)quad * 4],
+                        &side_layer.indices[(size_t)quad * 6], quad * 4);
+        ++quad;
       }
+      write_hex_top(corners, col.height, cr, cg, cb, 1.0f, &top_layer.vertices[c * 6],
+                    &top_layer.indices[c * 12], (uint32_t)c * 6);
     }
-  }
-
-  for (const auto &col : columns) {
-    uint32_t color = organic_color(col.base_height, col.q, col.r, palette);
-    float cr, cg, cb;
-    color_to_float(color, cr, cg, cb);
-
-    Vec2 corners[6];
-    get_hex_corners(col.q, col.r, Config::HEX_SIZE, corners);
-
-    add_hex_top(corners, col.height, cr, cg, cb, 1.0f, mesh.basalt_layers[1]);
-  }
+  });
 
   SDL_Log("TerrainMesh: %zu side verts, %zu side indices, %zu top verts, %zu top indices",
           mesh.basalt_layers[0].vertices.size(), mesh.basalt_layers[0].indices.size(),
           mesh.basalt_layers[1].vertices.size(), mesh.basalt_layers[1].indices.size());
+  SDL_Log("TerrainMesh: %zu column instances; basalt %zu bytes baked vs %zu instanced",
+          mesh.hex_instances.size(), mesh.baked_basalt_bytes, mesh.instanced_basalt_bytes);
 
   const float inv_unit = 1.0f / Config::HEX_SIZE;
+  mesh.tiles_x = std::max(1, (int)std::ceil(Config::MAP_WIDTH * inv_unit / Config::GEOMETRY_TILE_UNITS));
+  mesh.tiles_y = std::max(1, (int)std::ceil(Config::MAP_HEIGHT * inv_unit / Config::GEOMETRY_TILE_UNITS));
+  const int tile_count = mesh.tiles_x * mesh.tiles_y;
+  mesh.tile_bounds.assign(tile_count, {FLT_MAX, FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX});
+  mesh.lava_tiles.assign(tile_count, {0, 0});
+
+  size_t lava_vertex_total = 0, lava_index_total = 0;
+  for (const auto &lava : lava_bodies) {
+    lava_vertex_total += lava.mesh.vertices.size();
+    lava_index_total  += lava.mesh.indices.size();
+  }
+  mesh.lava_vertices.reserve(lava_vertex_total);
+  mesh.lava_indices.reserve(lava_index_total);
   for (const auto &lava : lava_bodies) {
     uint32_t base_idx = (uint32_t)mesh.lava_vertices.size();
     for (const auto &v : lava.mesh.vertices) {
@@ -131,25 +307,176 @@ TerrainMesh build_terrain_mesh(const TerrainState &terrain, const MapData &map_d
     }
   }
 
+  // Sum of the lava.vert wave amplitudes, rounded up; the flow sim can
+  // raise the surface by up to LAVA_FLOW_MAX_RISE on top.
+  constexpr float LAVA_WAVE_PAD = 0.05f;
+  sort_into_tiles(mesh.lava_vertices, mesh.lava_indices, 0, 3, LAVA_WAVE_PAD,
+                  LAVA_WAVE_PAD + Config::LAVA_FLOW_MAX_RISE,
+                  mesh, mesh.lava_tiles.data());
+
   SDL_Log("TerrainMesh: %zu lava vertices, %zu lava indices",
           mesh.lava_vertices.size(), mesh.lava_indices.size());
 
-  for (const auto &line : contours.contour_lines) {
-    float wx0 = line.x1 * inv_unit;
-    float wy0 = line.y1 * inv_unit;
-    float wx1 = line.x2 * inv_unit;
-    float wy1 = line.y2 * inv_unit;
-    float z   = line.elevation;
-    mesh.contour_vertices.push_back({wx0, wy0, z});
-    mesh.contour_vertices.push_back({wx1, wy1, z});
+  if (!map_data.lava_distance.empty()) {
+    mesh.glow_width  = map_data.width;
+    mesh.glow_height = map_data.height;
+    mesh.lava_glow.resize((size_t)map_data.width * map_data.height);
+    const float to_texel = 255.0f / (Config::LAVA_GLOW_RADIUS * Config::HEX_SIZE);
+    parallel_for(map_data.height, [&](int y) {
+      size_t row = (size_t)y * map_data.width;
+      for (int x = 0; x < map_data.width; ++x) {
+        float t = map_data.lava_distance[row + x] * to_texel;
+        mesh.lava_glow[row + x] = (uint8_t)std::min(t + 0.5f, 255.0f);
+      }
+    });
+  }
+
+  mesh.lava_lights = place_lava_lights(map_data, terrain.lava_light_budget);
+  SDL_Log("TerrainMesh: %zu lava lights (budget %d)",
+          mesh.lava_lights.size(), terrain.lava_light_budget);
+
+  // All LOD levels share one vertex/index buffer; each level is a
+  // contiguous index range.
+  size_t total_points = 0;
+  for (const auto &lod : contours.polyline_lods)
+    total_points += lod.points.size();
+  mesh.contour_vertices.reserve(total_points);
+  mesh.contour_indices.reserve(total_points * 2);
+  mesh.contour_tiles.assign(contours.polyline_lods.size() * tile_count, {0, 0});
+  for (const auto &polylines : contours.polyline_lods) {
+    TerrainMesh::IndexRange range{(uint32_t)mesh.contour_indices.size(), 0};
+    for (const auto &pl : polylines.lines) {
+      if (pl.count < 2)
+        continue;
+      uint32_t base = (uint32_t)mesh.contour_vertices.size();
+      for (uint32_t i = 0; i < pl.count; ++i) {
+        const Vec2 &p = polylines.points[pl.first + i];
+        mesh.contour_vertices.push_back({p.x * inv_unit, p.y * inv_unit, pl.elevation});
+      }
+      for (uint32_t i = 0; i + 1 < pl.count; ++i) {
+        mesh.contour_indices.push_back(base + i);
+        mesh.contour_indices.push_back(base + i + 1);
+      }
+      if (pl.closed) {
+        mesh.contour_indices.push_back(base + pl.count - 1);
+        mesh.contour_indices.push_back(base);
+      }
+    }
+    range.count = (uint32_t)mesh.contour_indices.size() - range.first;
+    sort_into_tiles(mesh.contour_vertices, mesh.contour_indices, range.first, 2,
+                    0.0f, 0.0f, mesh, &mesh.contour_tiles[mesh.contour_lods.size() * tile_count]);
+    mesh.contour_lods.push_back(range);
+    SDL_Log("TerrainMesh: contour LOD %zu: %zu polylines, %u indices",
+            mesh.contour_lods.size() - 1, polylines.lines.size(), range.count);
   }
 
-  SDL_Log("TerrainMesh: %zu contour vertices (%zu lines)",
-          mesh.contour_vertices.size(), contours.contour_lines.size());
+  SDL_Log("TerrainMesh: %zu contour vertices, %zu contour indices "
+          "(%zu LODs from %zu segments)",
+          mesh.contour_vertices.size(), mesh.contour_indices.size(),
+          mesh.contour_lods.size(), contours.contour_lines.size());
+
+  mesh.compact_vertices = terrain.compact_vertices;
+  if (mesh.compact_vertices)
+    mesh.packing = compute_vertex_packing(mesh);
 
   return mesh;
 }
 
+VertexPacking compute_vertex_packing(const TerrainMesh &mesh) {
+  float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  auto grow = [&](float x, float y, float z) {
+    lo[0] = std::min(lo[0], x); hi[0] = std::max(hi[0], x);
+    lo[1] = std::min(lo[1], y); hi[1] = std::max(hi[1], y);
+    lo[2] = std::min(lo[2], z); hi[2] = std::max(hi[2], z);
+  };
+  for (const auto &layer : mesh.basalt_layers)
+    for (const auto &v : layer.vertices)
+      grow(v.pos_x, v.pos_y, v.pos_z);
+  for (const auto &v : mesh.lava_vertices)
+    grow(v.pos_x, v.pos_y, v.pos_z + Config::LAVA_FLOW_MAX_RISE);
+  for (const auto &v : mesh.contour_vertices)
+    grow(v.pos_x, v.pos_y, v.pos_z);
+
+  VertexPacking p;
+  if (lo[0] > hi[0])
+    return p;
+  p.origin_x = lo[0];
+  p.origin_y = lo[1];
+  p.origin_z = lo[2];
+  p.extent_x = std::max(hi[0] - lo[0], 1e-6f);
+  p.extent_y = std::max(hi[1] - lo[1], 1e-6f);
+  p.extent_z = std::max(hi[2] - lo[2], 1e-6f);
+  return p;
+}
+
+static uint16_t to_unorm16(float v, float origin, float extent) {
+  float t = std::clamp((v - origin) / extent, 0.0f, 1.0f);
+  return (uint16_t)(t * 65535.0f + 0.5f);
+}
+
+// Octahedral encoding of a unit normal into two snorm16 values; a zero
+// normal comes back as (0, 0, 1).
+static void oct_encode(float nx, float ny, float nz, int16_t &u, int16_t &v) {
+  float l1 = std::fabs(nx) + std::fabs(ny) + std::fabs(nz);
+  float ox = 0.0f, oy = 0.0f;
+  if (l1 > 0.0f) {
+    ox = nx / l1;
+    oy = ny / l1;
+    if (nz < 0.0f) {
+      float fx = (1.0f - std::fabs(oy)) * (ox >= 0.0f ? 1.0f : -1.0f);
+      float fy = (1.0f - std::fabs(ox)) * (oy >= 0.0f ? 1.0f : -1.0f);
+      ox = fx;
+      oy = fy;
+    }
+  }
+  u = (int16_t)std::lround(std::clamp(ox, -1.0f, 1.0f) * 32767.0f);
+  v = (int16_t)std::lround(std::clamp(oy, -1.0f, 1.0f) * 32767.0f);
+}
+
+static uint8_t to_unorm8(float v) {
+  return (uint8_t)(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+void pack_basalt_vertices(std::span<const BasaltVertex> verts, const VertexPacking &p,
+                          PackedBasaltVertex *out) {
+  for (size_t i = 0; i < verts.size(); ++i) {
+    const BasaltVertex &v = verts[i];
+    PackedBasaltVertex &o = out[i];
+    o.pos_x   = to_unorm16(v.pos_x, p.origin_x, p.extent_x);
+    o.pos_y   = to_unorm16(v.pos_y, p.origin_y, p.extent_y);
+    o.pos_z   = to_unorm16(v.pos_z, p.origin_z, p.extent_z);
+    o._pad    = 0;
+    o.color_r = to_unorm8(v.color_r);
+    o.color_g = to_unorm8(v.color_g);
+    o.color_b = to_unorm8(v.color_b);
+    o.sheen   = to_unorm8(v.sheen);
+    oct_encode(v.nx, v.ny, v.nz, o.normal_u, o.normal_v);
+  }
+}
+
+void pack_lava_vertices(std::span<const GpuLavaVertex> verts, const VertexPacking &p,
+                        PackedLavaVertex *out) {
+  constexpr float TWO_PI = 6.283185f;
+  for (size_t i = 0; i < verts.size(); ++i) {
+    const GpuLavaVertex &v = verts[i];
+    out[i].pos_x = to_unorm16(v.pos_x, p.origin_x, p.extent_x);
+    out[i].pos_y = to_unorm16(v.pos_y, p.origin_y, p.extent_y);
+    out[i].pos_z = to_unorm16(v.pos_z, p.origin_z, p.extent_z);
+    out[i].time_offset = to_unorm16(std::fmod(v.time_offset, TWO_PI), 0.0f, TWO_PI);
+  }
+}
+
+void pack_contour_vertices(std::span<const ContourVertex> verts, const VertexPacking &p,
+                           PackedContourVertex *out) {
+  for (size_t i = 0; i < verts.size(); ++i) {
+    const ContourVertex &v = verts[i];
+    out[i] = {to_unorm16(v.pos_x, p.origin_x, p.extent_x),
+              to_unorm16(v.pos_y, p.origin_y, p.extent_y),
+              to_unorm16(v.pos_z, p.origin_z, p.extent_z), 0};
+  }
+}
+
 SceneUniforms compute_uniforms(const MapData &map_data,
                                const glm::mat4 &view, const glm::mat4 &projection,
                                uint32_t cluster_tiles_x, uint32_t cluster_tiles_y,
@@ -191,5 +518,14 @@ SceneUniforms compute_uniforms(const MapData &map_data,
   u.far_plane     =  500.0f;
   u.light_count_f = (float)light_count;
 
+  u.pack_extent_x = u.pack_extent_y = u.pack_extent_z = 1.0f;
+
+  u.glow_radius    = Config::LAVA_GLOW_RADIUS;
+  u.glow_intensity = Config::LAVA_GLOW_INTENSITY;
+  if (map_data.width > 0 && map_data.height > 0) {
+    u.glow_scale_x = Config::HEX_SIZE / map_data.width;
+    u.glow_scale_y = Config::HEX_SIZE / map_data.height;
+  }
+
   return u;
 }
@@ -1,11 +1,13 @@
 #pragma once
 #include "terrain/map_data.h"
 #include <cstdint>
+#include <span>
 #include <vector>
 #include <glm/glm.hpp>
 
 struct TerrainState;
 struct ContourData;
+struct Palette;
 
 struct BasaltVertex {
   float pos_x, pos_y, pos_z;
@@ -14,6 +16,26 @@ struct BasaltVertex {
   float nx, ny, nz;
 };
 
+// Vertex of the canonical unit hex prism the instanced column path expands
+// (hex_column.vert.glsl): side faces 0-5, then the top cap as face 6.
+struct GpuHexPrismVertex {
+  float ux, uy; // unit corner, HEX_UNIT_CORNERS
+  float top;    // 1 on the top rim, 0 on the bottom of a side face
+  float face;
+  float nx, ny, nz;
+};
+
+// One basalt column for the instanced path; 24 bytes against ~500 for the
+// baked vertices and indices of a typical column.
+struct GpuHexInstance {
+  int16_t q, r;
+  float height;
+  uint8_t color_r, color_g, color_b;
+  uint8_t edge_mask;  // bit i: side face i is drawn (has_side_face)
+  uint16_t drops[6];  // edge_drops / Config::HEX_DROP_RANGE, unorm16, rounded up
+};
+static_assert(sizeof(GpuHexInstance) == 24, "GpuHexInstance layout is read by hex_column.vert");
+
 struct GpuLavaVertex {
   float pos_x, pos_y, pos_z;
   float time_offset;
@@ -23,6 +45,35 @@ struct ContourVertex {
   float pos_x, pos_y, pos_z;
 };
 
+// Compact vertex formats, uploaded instead of the float ones when
+// TerrainMesh::compact_vertices is set and read by the *_packed.vert.glsl
+// shaders. Positions are unorm16 over the mesh's VertexPacking box.
+struct PackedBasaltVertex {
+  uint16_t pos_x, pos_y, pos_z, _pad;
+  uint8_t  color_r, color_g, color_b;
+  uint8_t  sheen;
+  int16_t  normal_u, normal_v; // octahedral, snorm16
+};
+static_assert(sizeof(PackedBasaltVertex) == 16, "PackedBasaltVertex layout is read by terrain_packed.vert");
+
+struct PackedLavaVertex {
+  uint16_t pos_x, pos_y, pos_z;
+  uint16_t time_offset; // unorm16 over one wave period (2 pi)
+};
+static_assert(sizeof(PackedLavaVertex) == 8, "PackedLavaVertex layout is read by lava_packed.vert");
+
+struct PackedContourVertex {
+  uint16_t pos_x, pos_y, pos_z, _pad;
+};
+static_assert(sizeof(PackedContourVertex) == 8, "PackedContourVertex layout is read by contour_packed.vert");
+
+// World-space box packed positions are quantised over; decoded as
+// origin + unorm * extent.
+struct VertexPacking {
+  float origin_x = 0.0f, origin_y = 0.0f, origin_z = 0.0f;
+  float extent_x = 1.0f, extent_y = 1.0f, extent_z = 1.0f;
+};
+
 struct SceneUniforms {
   glm::mat4 view;
   glm::mat4 projection;
@@ -40,6 +91,13 @@ struct SceneUniforms {
   float grid_size_x, grid_size_y, num_slices, tile_px;
 
   float near_plane, far_plane, light_count_f, _pad4;
+
+  // Lava glow: radius and intensity, then world units to glow texture UV.
+  float glow_radius, glow_intensity, glow_scale_x, glow_scale_y;
+
+  // VertexPacking of the bound buffers; identity for float vertices.
+  float pack_origin_x, pack_origin_y, pack_origin_z, _pad5;
+  float pack_extent_x, pack_extent_y, pack_extent_z, _pad6;
 };
 
 struct GpuPointLight {
@@ -49,20 +107,79 @@ struct GpuPointLight {
 static_assert(sizeof(GpuPointLight) == 32, "GpuPointLight must be 32 bytes for std430");
 
 struct TerrainMesh {
+  struct IndexRange {
+    uint32_t first, count;
+  };
+
+  // World-space bounds of the geometry bucketed into one tile.
+  struct TileBounds {
+    float min_x, min_y, min_z;
+    float max_x, max_y, max_z;
+  };
+
   struct RenderingLayer {
     std::vector<BasaltVertex> vertices;
     std::vector<uint32_t> indices;
   };
 
+  // Baked basalt (sides, tops); empty when TerrainState::instanced_columns
+  // is set, in which case the columns are drawn from hex_instances.
   std::vector<RenderingLayer> basalt_layers;
+  std::vector<GpuHexInstance>    hex_instances;  // one per MapData::columns entry
+  std::vector<GpuHexPrismVertex> hex_prism_vertices;
+  std::vector<uint32_t>          hex_prism_indices;
+  // CPU-side size of each basalt representation, for the Resources panel.
+  size_t baked_basalt_bytes     = 0;
+  size_t instanced_basalt_bytes = 0;
   std::vector<GpuLavaVertex>  lava_vertices;
   std::vector<uint32_t>       lava_indices;
   std::vector<ContourVertex>  contour_vertices;
+  std::vector<uint32_t>       contour_indices;  // line list over contour_vertices
+  std::vector<IndexRange>     contour_lods;     // per LOD level, finest first
+
+  // Lava triangles and contour segments are sorted into square world tiles
+  // of Config::GEOMETRY_TILE_UNITS; each tile's primitives are contiguous
+  // in its index buffer.
+  int tiles_x = 0, tiles_y = 0;
+  std::vector<TileBounds>     tile_bounds;      // per tile, lava + contours
+  std::vector<IndexRange>     lava_tiles;       // per tile
+  std::vector<IndexRange>     contour_tiles;    // [lod * tile count + tile]
+
+  // Lava glow texture, one R8 texel per map pixel: distance to the nearest
+  // lava pixel as a fraction of Config::LAVA_GLOW_RADIUS, 255 at or past it.
+  int glow_width = 0, glow_height = 0;
+  std::vector<uint8_t> lava_glow;
+
+  // Clustered lava point lights, at most TerrainState::lava_light_budget.
+  std::vector<GpuPointLight> lava_lights;
+
+  // Upload basalt, lava and contours in the Packed* formats, with 16-bit
+  // indices wherever a buffer has at most 65536 vertices.
+  bool          compact_vertices = false;
+  VertexPacking packing;
 };
 
 TerrainMesh build_terrain_mesh(const TerrainState &terrain, const MapData &map_data,
                                const ContourData &contours);
 
+// Recomputes instance colours from columns (same order) under palette, so a
+// palette change is an instance buffer update rather than a rebuild.
+void recolor_hex_instances(std::span<GpuHexInstance> instances,
+                           std::span<const HexColumn> columns, const Palette &palette);
+
+// Box covering every basalt, lava and contour vertex, with headroom above
+// for the lava flow raising the lava surface.
+VertexPacking compute_vertex_packing(const TerrainMesh &mesh);
+
+// Quantise float vertices into out (same count); positions outside the box
+// are clamped.
+void pack_basalt_vertices(std::span<const BasaltVertex> verts, const VertexPacking &packing,
+                          PackedBasaltVertex *out);
+void pack_lava_vertices(std::span<const GpuLavaVertex> verts, const VertexPacking &packing,
+                        PackedLavaVertex *out);
+void pack_contour_vertices(std::span<const ContourVertex> verts, const VertexPacking &packing,
+                           PackedContourVertex *out);
+
 SceneUniforms compute_uniforms(const MapData &map_data,
                                const glm::mat4 &view, const glm::mat4 &projection,
                                uint32_t cluster_tiles_x, uint32_t cluster_tiles_y,
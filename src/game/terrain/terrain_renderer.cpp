@@ -1,7 +1,10 @@
 #include "terrain/terrain_renderer.h"
+#include "config.h"
 #include "gpu/gpu.h"
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_gpu.h>
+#include <algorithm>
+#include <cfloat>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -83,6 +86,15 @@ void TerrainRenderer::init(SDL_GPUDevice *device, SDL_Window *window, AssetManag
       SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ |
       SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ);
 
+  SDL_GPUSamplerCreateInfo si = {};
+  si.min_filter     = SDL_GPU_FILTER_LINEAR;
+  si.mag_filter     = SDL_GPU_FILTER_LINEAR;
+  si.mipmap_mode    = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST;
+  si.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+  si.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+  si.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+  lava_glow_sampler = SDL_CreateGPUSampler(device, &si);
+
   initialized = true;
   SDL_Log("TerrainRenderer: Initialized (graphics + compute pipelines)");
 }
@@ -103,7 +115,7 @@ void TerrainRenderer::init_graphics_pipelines(SDL_GPUDevice *device, SDL_Window
         SDL_GPU_SHADERSTAGE_VERTEX, 1, 0);
     SDL_GPUShader *frag = asset_manager->load_shader(
         "terrain.frag", shader_dir + "/terrain.frag.glsl.spv",
-        SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 3);
+        SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 3, 1);
 
     if (!vert || !frag) {
       if (vert) SDL_ReleaseGPUShader(device, vert);
@@ -150,6 +162,10 @@ void TerrainRenderer::init_graphics_pipelines(SDL_GPUDevice *device, SDL_Window
   }
 
 
+  hex_column_pipeline = build_hex_column_pipeline(swapchain_format);
+  asset_manager->register_pipeline("hex_column", "hex_column.vert", "terrain.frag");
+
+
   {
     SDL_GPUShader *vert = asset_manager->load_shader(
         "lava.vert", shader_dir + "/lava.vert.glsl.spv",
@@ -244,12 +260,140 @@ void TerrainRenderer::init_graphics_pipelines(SDL_GPUDevice *device, SDL_Window
     // Shaders owned by asset_manager.
   }
 
+  terrain_packed_pipeline = build_packed_pipeline("terrain", swapchain_format);
+  lava_packed_pipeline    = build_packed_pipeline("lava",    swapchain_format);
+  contour_packed_pipeline = build_packed_pipeline("contour", swapchain_format);
+  asset_manager->register_pipeline("terrain_packed", "terrain_packed.vert", "terrain.frag");
+  asset_manager->register_pipeline("lava_packed",    "lava_packed.vert",    "lava.frag");
+  asset_manager->register_pipeline("contour_packed", "contour_packed.vert", "contour.frag");
+
   SDL_Log("TerrainRenderer: Graphics pipelines created");
 }
 
 
 
 
+// Basalt columns as instances of the unit prism: slot 0 is the prism, slot 1
+// one GpuHexInstance per column. Shares terrain.frag with the baked path.
+SDL_GPUGraphicsPipeline *TerrainRenderer::build_hex_column_pipeline(
+    SDL_GPUTextureFormat swapchain_format) {
+  std::string shader_dir = SHADER_DIR;
+  SDL_GPUShader *vert = asset_manager->load_shader(
+      "hex_column.vert", shader_dir + "/hex_column.vert.glsl.spv",
+      SDL_GPU_SHADERSTAGE_VERTEX, 1, 0);
+  SDL_GPUShader *frag = asset_manager->load_shader(
+      "terrain.frag", shader_dir + "/terrain.frag.glsl.spv",
+      SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 3, 1);
+  if (!vert || !frag) return nullptr;
+
+  SDL_GPUVertexBufferDescription vbuf_desc[2] = {};
+  vbuf_desc[0].slot       = 0;
+  vbuf_desc[0].pitch      = sizeof(GpuHexPrismVertex);
+  vbuf_desc[0].input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
+  vbuf_desc[1].slot       = 1;
+  vbuf_desc[1].pitch      = sizeof(GpuHexInstance);
+  vbuf_desc[1].input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE;
+
+  SDL_GPUVertexAttribute attrs[9] = {};
+  attrs[0] = { 0, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,       (Uint32)offsetof(GpuHexPrismVertex, ux)   };
+  attrs[1] = { 1, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,        (Uint32)offsetof(GpuHexPrismVertex, top)  };
+  attrs[2] = { 2, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,        (Uint32)offsetof(GpuHexPrismVertex, face) };
+  attrs[3] = { 3, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,       (Uint32)offsetof(GpuHexPrismVertex, nx)   };
+  attrs[4] = { 4, 1, SDL_GPU_VERTEXELEMENTFORMAT_SHORT2,       (Uint32)offsetof(GpuHexInstance, q)       };
+  attrs[5] = { 5, 1, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,        (Uint32)offsetof(GpuHexInstance, height)  };
+  attrs[6] = { 6, 1, SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,  (Uint32)offsetof(GpuHexInstance, color_r) };
+  attrs[7] = { 7, 1, SDL_GPU_VERTEXELEMENTFORMAT_USHORT4_NORM, (Uint32)offsetof(GpuHexInstance, drops)   };
+  attrs[8] = { 8, 1, SDL_GPU_VERTEXELEMENTFORMAT_USHORT2_NORM, (Uint32)offsetof(GpuHexInstance, drops) + 8 };
+
+  SDL_GPUColorTargetDescription color_desc = {};
+  color_desc.format = swapchain_format;
+
+  SDL_GPUGraphicsPipelineCreateInfo pi = {};
+  pi.vertex_shader   = vert;
+  pi.fragment_shader = frag;
+  pi.vertex_input_state.vertex_buffer_descriptions = vbuf_desc;
+  pi.vertex_input_state.num_vertex_buffers         = 2;
+  pi.vertex_input_state.vertex_attributes          = attrs;
+  pi.vertex_input_state.num_vertex_attributes      = 9;
+  pi.primitive_type  = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+  pi.target_info.color_target_descriptions         = &color_desc;
+  pi.target_info.num_color_targets                 = 1;
+  pi.target_info.has_depth_stencil_target          = true;
+  pi.target_info.depth_stencil_format              = depth_stencil_format;
+  pi.depth_stencil_state.compare_op                = SDL_GPU_COMPAREOP_LESS_OR_EQUAL;
+  pi.depth_stencil_state.enable_depth_test         = true;
+  pi.depth_stencil_state.enable_depth_write        = true;
+  return SDL_CreateGPUGraphicsPipeline(gpu_device, &pi);
+}
+
+SDL_GPUGraphicsPipeline *TerrainRenderer::build_packed_pipeline(
+    const std::string &name, SDL_GPUTextureFormat swapchain_format) {
+  std::string shader_dir = SHADER_DIR;
+  bool terrain = name == "terrain";
+  SDL_GPUShader *vert = asset_manager->load_shader(
+      name + "_packed.vert", shader_dir + "/" + name + "_packed.vert.glsl.spv",
+      SDL_GPU_SHADERSTAGE_VERTEX, 1, 0);
+  SDL_GPUShader *frag = terrain
+      ? asset_manager->load_shader("terrain.frag", shader_dir + "/terrain.frag.glsl.spv",
+                                   SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 3, 1)
+      : asset_manager->load_shader(name + ".frag", shader_dir + "/" + name + ".frag.glsl.spv",
+                                   SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0);
+  if (!vert || !frag) return nullptr;
+
+  SDL_GPUVertexBufferDescription vbuf_desc = {};
+  vbuf_desc.slot       = 0;
+  vbuf_desc.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
+
+  SDL_GPUVertexAttribute attrs[3] = {};
+  Uint32 num_attrs = 1;
+  attrs[0] = { 0, 0, SDL_GPU_VERTEXELEMENTFORMAT_USHORT4_NORM, 0 };
+  if (terrain) {
+    vbuf_desc.pitch = sizeof(PackedBasaltVertex);
+    attrs[1] = { 1, 0, SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM, (Uint32)offsetof(PackedBasaltVertex, color_r)  };
+    attrs[2] = { 2, 0, SDL_GPU_VERTEXELEMENTFORMAT_SHORT2_NORM, (Uint32)offsetof(PackedBasaltVertex, normal_u) };
+    num_attrs = 3;
+  } else if (name == "lava") {
+    vbuf_desc.pitch = sizeof(PackedLavaVertex);
+  } else {
+    vbuf_desc.pitch = sizeof(PackedContourVertex);
+  }
+
+  SDL_GPUColorTargetDescription color_desc = {};
+  color_desc.format = swapchain_format;
+
+  SDL_GPUGraphicsPipelineCreateInfo pi = {};
+  pi.vertex_shader   = vert;
+  pi.fragment_shader = frag;
+  pi.vertex_input_state.vertex_buffer_descriptions = &vbuf_desc;
+  pi.vertex_input_state.num_vertex_buffers         = 1;
+  pi.vertex_input_state.vertex_attributes          = attrs;
+  pi.vertex_input_state.num_vertex_attributes      = num_attrs;
+  pi.primitive_type  = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+  pi.target_info.color_target_descriptions         = &color_desc;
+  pi.target_info.num_color_targets                 = 1;
+  pi.target_info.has_depth_stencil_target          = true;
+  pi.target_info.depth_stencil_format              = depth_stencil_format;
+  pi.depth_stencil_state.compare_op                = terrain ? SDL_GPU_COMPAREOP_LESS_OR_EQUAL
+                                                             : SDL_GPU_COMPAREOP_LESS;
+  pi.depth_stencil_state.enable_depth_test         = true;
+  pi.depth_stencil_state.enable_depth_write        = true;
+
+  if (name == "contour") {
+    color_desc.blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA;
+    color_desc.blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA;
+    color_desc.blend_state.color_blend_op        = SDL_GPU_BLENDOP_ADD;
+    color_desc.blend_state.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+    color_desc.blend_state.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA;
+    color_desc.blend_state.alpha_blend_op        = SDL_GPU_BLENDOP_ADD;
+    color_desc.blend_state.enable_blend          = true;
+    pi.primitive_type = SDL_GPU_PRIMITIVETYPE_LINELIST;
+    pi.depth_stencil_state.compare_op         = SDL_GPU_COMPAREOP_ALWAYS;
+    pi.depth_stencil_state.enable_depth_test  = false;
+    pi.depth_stencil_state.enable_depth_write = false;
+  }
+  return SDL_CreateGPUGraphicsPipeline(gpu_device, &pi);
+}
+
 void TerrainRenderer::init_compute_pipelines(SDL_GPUDevice *device) {
   std::string shader_dir = SHADER_DIR;
   SDL_Log("TerrainRenderer: Loading compute shaders from %s", shader_dir.c_str());
@@ -278,6 +422,15 @@ void TerrainRenderer::init_compute_pipelines(SDL_GPUDevice *device) {
 
 
 
+void TerrainRenderer::select_contour_lod(float zoom) {
+  // One level coarser (tolerance doubled) per halving of zoom below
+  // CONTOUR_LOD_FULL_ZOOM.
+  int lod = 0;
+  if (zoom > 0.0f && zoom < Config::CONTOUR_LOD_FULL_ZOOM)
+    lod = (int)std::floor(std::log2(Config::CONTOUR_LOD_FULL_ZOOM / zoom));
+  contour_lod = std::clamp(lod, 0, Config::CONTOUR_LOD_LEVELS - 1);
+}
+
 void TerrainRenderer::rebuild_dirty_pipelines(SDL_Window *window) {
   if (!asset_manager || !gpu_device) return;
 
@@ -299,7 +452,7 @@ void TerrainRenderer::rebuild_dirty_pipelines(SDL_Window *window) {
 
   rebuild_graphics("terrain", terrain_pipeline, [&]() -> SDL_GPUGraphicsPipeline * {
     SDL_GPUShader *vert = asset_manager->load_shader("terrain.vert", shader_dir + "/terrain.vert.glsl.spv", SDL_GPU_SHADERSTAGE_VERTEX, 1, 0);
-    SDL_GPUShader *frag = asset_manager->load_shader("terrain.frag", shader_dir + "/terrain.frag.glsl.spv", SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 3);
+    SDL_GPUShader *frag = asset_manager->load_shader("terrain.frag", shader_dir + "/terrain.frag.glsl.spv", SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 3, 1);
     if (!vert || !frag) return nullptr;
     SDL_GPUVertexBufferDescription vbuf_desc = {};
     vbuf_desc.slot = 0; vbuf_desc.pitch = sizeof(BasaltVertex); vbuf_desc.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX;
@@ -324,6 +477,20 @@ void TerrainRenderer::rebuild_dirty_pipelines(SDL_Window *window) {
   if (asset_manager->pipeline_needs_rebuild("terrain_stencil"))
     asset_manager->clear_rebuild_flag("terrain_stencil");
 
+  rebuild_graphics("hex_column", hex_column_pipeline, [&]() {
+    return build_hex_column_pipeline(swapchain_format);
+  });
+
+  rebuild_graphics("terrain_packed", terrain_packed_pipeline, [&]() {
+    return build_packed_pipeline("terrain", swapchain_format);
+  });
+  rebuild_graphics("lava_packed", lava_packed_pipeline, [&]() {
+    return build_packed_pipeline("lava", swapchain_format);
+  });
+  rebuild_graphics("contour_packed", contour_packed_pipeline, [&]() {
+    return build_packed_pipeline("contour", swapchain_format);
+  });
+
   rebuild_graphics("lava", lava_pipeline, [&]() -> SDL_GPUGraphicsPipeline * {
     SDL_GPUShader *vert = asset_manager->load_shader("lava.vert", shader_dir + "/lava.vert.glsl.spv", SDL_GPU_SHADERSTAGE_VERTEX, 1, 0);
     SDL_GPUShader *frag = asset_manager->load_shader("lava.frag", shader_dir + "/lava.frag.glsl.spv", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0);
@@ -488,23 +655,55 @@ void TerrainRenderer::upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh
   }
   basalt_total_index_count = (uint32_t)all_indices.size();
 
+  // Compact meshes upload Packed* vertices, and 16-bit indices for each
+  // buffer whose vertices all fit.
+  compact = mesh.compact_vertices;
+  packing = mesh.packing;
+  auto index_size_for = [&](size_t vertex_count) {
+    return compact && vertex_count <= 65536 ? SDL_GPU_INDEXELEMENTSIZE_16BIT
+                                            : SDL_GPU_INDEXELEMENTSIZE_32BIT;
+  };
+  auto index_bytes = [](SDL_GPUIndexElementSize size) -> uint32_t {
+    return size == SDL_GPU_INDEXELEMENTSIZE_16BIT ? 2 : 4;
+  };
+  basalt_index_size  = index_size_for(all_verts.size());
+  lava_index_size    = index_size_for(mesh.lava_vertices.size());
+  contour_index_size = index_size_for(mesh.contour_vertices.size());
+
   // --- Compute total staging size and create one shared transfer buffer ---
 
-  uint32_t basalt_vbo_sz    = (uint32_t)(all_verts.size()                    * sizeof(BasaltVertex));
-  uint32_t basalt_ibo_sz    = (uint32_t)(all_indices.size()                  * sizeof(uint32_t));
-  uint32_t lava_vbo_sz      = (uint32_t)(mesh.lava_vertices.size()           * sizeof(GpuLavaVertex));
-  uint32_t lava_ibo_sz      = (uint32_t)(mesh.lava_indices.size()            * sizeof(uint32_t));
-  uint32_t contour_vbo_sz   = (uint32_t)(mesh.contour_vertices.size()        * sizeof(ContourVertex));
+  uint32_t basalt_vbo_sz    = (uint32_t)(all_verts.size()                    * (compact ? sizeof(PackedBasaltVertex) : sizeof(BasaltVertex)));
+  uint32_t basalt_ibo_sz    = (uint32_t)(all_indices.size()                  * index_bytes(basalt_index_size));
+  uint32_t prism_vbo_sz     = (uint32_t)(mesh.hex_prism_vertices.size()      * sizeof(GpuHexPrismVertex));
+  uint32_t prism_ibo_sz     = (uint32_t)(mesh.hex_prism_indices.size()       * sizeof(uint32_t));
+  uint32_t instance_vbo_sz  = (uint32_t)(mesh.hex_instances.size()           * sizeof(GpuHexInstance));
+  uint32_t lava_vbo_sz      = (uint32_t)(mesh.lava_vertices.size()           * (compact ? sizeof(PackedLavaVertex) : sizeof(GpuLavaVertex)));
+  uint32_t lava_ibo_sz      = (uint32_t)(mesh.lava_indices.size()            * index_bytes(lava_index_size));
+  uint32_t contour_vbo_sz   = (uint32_t)(mesh.contour_vertices.size()        * (compact ? sizeof(PackedContourVertex) : sizeof(ContourVertex)));
+  uint32_t contour_ibo_sz   = (uint32_t)(mesh.contour_indices.size()         * index_bytes(contour_index_size));
+
+  // The glow texture always exists while a mesh is bound; a map without
+  // lava gets a single texel past the glow radius.
+  static const uint8_t no_glow = 255;
+  const uint8_t *glow_data = mesh.lava_glow.empty() ? &no_glow : mesh.lava_glow.data();
+  uint32_t glow_w  = mesh.lava_glow.empty() ? 1 : (uint32_t)mesh.glow_width;
+  uint32_t glow_h  = mesh.lava_glow.empty() ? 1 : (uint32_t)mesh.glow_height;
+  uint32_t glow_sz = glow_w * glow_h;
 
   // Align each section to 4 bytes so GPU buffer offsets are valid.
   auto align4 = [](uint32_t v) { return (v + 3u) & ~3u; };
 
   uint32_t off_basalt_vbo  = 0;
   uint32_t off_basalt_ibo  = off_basalt_vbo  + align4(basalt_vbo_sz);
-  uint32_t off_lava_vbo    = off_basalt_ibo  + align4(basalt_ibo_sz);
+  uint32_t off_prism_vbo   = off_basalt_ibo  + align4(basalt_ibo_sz);
+  uint32_t off_prism_ibo   = off_prism_vbo   + align4(prism_vbo_sz);
+  uint32_t off_instances   = off_prism_ibo   + align4(prism_ibo_sz);
+  uint32_t off_lava_vbo    = off_instances   + align4(instance_vbo_sz);
   uint32_t off_lava_ibo    = off_lava_vbo    + align4(lava_vbo_sz);
   uint32_t off_contour_vbo = off_lava_ibo    + align4(lava_ibo_sz);
-  uint32_t total_sz        = off_contour_vbo + align4(contour_vbo_sz);
+  uint32_t off_contour_ibo = off_contour_vbo + align4(contour_vbo_sz);
+  uint32_t off_glow        = off_contour_ibo + align4(contour_ibo_sz);
+  uint32_t total_sz        = off_glow        + align4(glow_sz);
 
   if (total_sz == 0) {
     has_data = false;
@@ -530,12 +729,36 @@ void TerrainRenderer::upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh
     return;
   }
 
-  // Copy all sections into the staging buffer.
-  if (basalt_vbo_sz)  SDL_memcpy(mapped + off_basalt_vbo,  all_verts.data(),               basalt_vbo_sz);
-  if (basalt_ibo_sz)  SDL_memcpy(mapped + off_basalt_ibo,  all_indices.data(),              basalt_ibo_sz);
-  if (lava_vbo_sz)    SDL_memcpy(mapped + off_lava_vbo,    mesh.lava_vertices.data(),       lava_vbo_sz);
-  if (lava_ibo_sz)    SDL_memcpy(mapped + off_lava_ibo,    mesh.lava_indices.data(),        lava_ibo_sz);
-  if (contour_vbo_sz) SDL_memcpy(mapped + off_contour_vbo, mesh.contour_vertices.data(),    contour_vbo_sz);
+  // Copy all sections into the staging buffer, packing on the way in when
+  // compact.
+  auto copy_indices = [&](uint32_t off, const std::vector<uint32_t> &indices,
+                          SDL_GPUIndexElementSize size) {
+    if (indices.empty()) return;
+    if (size == SDL_GPU_INDEXELEMENTSIZE_32BIT) {
+      SDL_memcpy(mapped + off, indices.data(), indices.size() * sizeof(uint32_t));
+      return;
+    }
+    uint16_t *dst = (uint16_t *)(mapped + off);
+    for (size_t i = 0; i < indices.size(); ++i)
+      dst[i] = (uint16_t)indices[i];
+  };
+  if (compact) {
+    pack_basalt_vertices(all_verts, packing, (PackedBasaltVertex *)(mapped + off_basalt_vbo));
+    pack_lava_vertices(mesh.lava_vertices, packing, (PackedLavaVertex *)(mapped + off_lava_vbo));
+    pack_contour_vertices(mesh.contour_vertices, packing,
+                          (PackedContourVertex *)(mapped + off_contour_vbo));
+  } else {
+    if (basalt_vbo_sz)  SDL_memcpy(mapped + off_basalt_vbo,  all_verts.data(),               basalt_vbo_sz);
+    if (lava_vbo_sz)    SDL_memcpy(mapped + off_lava_vbo,    mesh.lava_vertices.data(),       lava_vbo_sz);
+    if (contour_vbo_sz) SDL_memcpy(mapped + off_contour_vbo, mesh.contour_vertices.data(),    contour_vbo_sz);
+  }
+  copy_indices(off_basalt_ibo,  all_indices,          basalt_index_size);
+  copy_indices(off_lava_ibo,    mesh.lava_indices,    lava_index_size);
+  copy_indices(off_contour_ibo, mesh.contour_indices, contour_index_size);
+  if (prism_vbo_sz)   SDL_memcpy(mapped + off_prism_vbo,   mesh.hex_prism_vertices.data(),  prism_vbo_sz);
+  if (prism_ibo_sz)   SDL_memcpy(mapped + off_prism_ibo,   mesh.hex_prism_indices.data(),   prism_ibo_sz);
+  if (instance_vbo_sz) SDL_memcpy(mapped + off_instances,  mesh.hex_instances.data(),       instance_vbo_sz);
+  SDL_memcpy(mapped + off_glow, glow_data, glow_sz);
 
   SDL_UnmapGPUTransferBuffer(device, transfer);
 
@@ -545,6 +768,15 @@ void TerrainRenderer::upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh
     basalt_vbo = gpu_create_buffer(device, basalt_vbo_sz,  SDL_GPU_BUFFERUSAGE_VERTEX);
     basalt_ibo = gpu_create_buffer(device, basalt_ibo_sz,  SDL_GPU_BUFFERUSAGE_INDEX);
   }
+  // Baked layers are left empty when the mesh is instanced; the prism is
+  // only drawn when they are.
+  if (basalt_total_index_count == 0 && prism_vbo_sz && prism_ibo_sz && instance_vbo_sz) {
+    hex_prism_vbo         = gpu_create_buffer(device, prism_vbo_sz,    SDL_GPU_BUFFERUSAGE_VERTEX);
+    hex_prism_ibo         = gpu_create_buffer(device, prism_ibo_sz,    SDL_GPU_BUFFERUSAGE_INDEX);
+    hex_instance_vbo      = gpu_create_buffer(device, instance_vbo_sz, SDL_GPU_BUFFERUSAGE_VERTEX);
+    hex_prism_index_count = (uint32_t)mesh.hex_prism_indices.size();
+    hex_instance_count    = (uint32_t)mesh.hex_instances.size();
+  }
   if (lava_vbo_sz) {
     lava_vbo          = gpu_create_buffer(device, lava_vbo_sz,    SDL_GPU_BUFFERUSAGE_VERTEX);
     lava_vertex_count = (uint32_t)mesh.lava_vertices.size();
@@ -553,10 +785,32 @@ void TerrainRenderer::upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh
     lava_ibo          = gpu_create_buffer(device, lava_ibo_sz,    SDL_GPU_BUFFERUSAGE_INDEX);
     lava_index_count  = (uint32_t)mesh.lava_indices.size();
   }
-  if (contour_vbo_sz) {
+  if (contour_vbo_sz && contour_ibo_sz) {
     contour_vbo          = gpu_create_buffer(device, contour_vbo_sz, SDL_GPU_BUFFERUSAGE_VERTEX);
+    contour_ibo          = gpu_create_buffer(device, contour_ibo_sz, SDL_GPU_BUFFERUSAGE_INDEX);
     contour_vertex_count = (uint32_t)mesh.contour_vertices.size();
+    contour_index_count  = (uint32_t)mesh.contour_indices.size();
+    contour_lod_ranges   = mesh.contour_lods;
+  }
+  {
+    SDL_GPUTextureCreateInfo gi = {};
+    gi.type                 = SDL_GPU_TEXTURETYPE_2D;
+    gi.format               = SDL_GPU_TEXTUREFORMAT_R8_UNORM;
+    gi.width                = glow_w;
+    gi.height               = glow_h;
+    gi.layer_count_or_depth = 1;
+    gi.num_levels           = 1;
+    gi.usage                = SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    lava_glow_texture = SDL_CreateGPUTexture(device, &gi);
+    if (!lava_glow_texture)
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                   "TerrainRenderer::upload_mesh: Failed to create glow texture: %s", SDL_GetError());
   }
+  tile_bounds         = mesh.tile_bounds;
+  lava_tile_ranges    = mesh.lava_tiles;
+  contour_tile_ranges = mesh.contour_tiles;
+  tile_visible.assign(tile_bounds.size(), 1);
+  visible_tiles       = (uint32_t)tile_bounds.size();
 
   // --- One command buffer, one copy pass, all uploads ---
 
@@ -572,9 +826,18 @@ void TerrainRenderer::upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh
 
   upload(basalt_vbo,  off_basalt_vbo,  basalt_vbo_sz);
   upload(basalt_ibo,  off_basalt_ibo,  basalt_ibo_sz);
+  upload(hex_prism_vbo,    off_prism_vbo, prism_vbo_sz);
+  upload(hex_prism_ibo,    off_prism_ibo, prism_ibo_sz);
+  upload(hex_instance_vbo, off_instances, instance_vbo_sz);
   upload(lava_vbo,    off_lava_vbo,    lava_vbo_sz);
   upload(lava_ibo,    off_lava_ibo,    lava_ibo_sz);
   upload(contour_vbo, off_contour_vbo, contour_vbo_sz);
+  upload(contour_ibo, off_contour_ibo, contour_ibo_sz);
+  if (lava_glow_texture) {
+    SDL_GPUTextureTransferInfo src = { transfer, off_glow, glow_w, glow_h };
+    SDL_GPUTextureRegion       dst = { lava_glow_texture, 0, 0, 0, 0, 0, glow_w, glow_h, 1 };
+    SDL_UploadToGPUTexture(copy, &src, &dst, false);
+  }
 
   SDL_EndGPUCopyPass(copy);
   SDL_SubmitGPUCommandBuffer(cmd);
@@ -588,15 +851,89 @@ void TerrainRenderer::upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh
   if (asset_manager) {
     if (basalt_vbo)  asset_manager->register_buffer("basalt_vbo",  basalt_vbo);
     if (basalt_ibo)  asset_manager->register_buffer("basalt_ibo",  basalt_ibo);
+    if (hex_prism_vbo)    asset_manager->register_buffer("hex_prism_vbo",    hex_prism_vbo);
+    if (hex_prism_ibo)    asset_manager->register_buffer("hex_prism_ibo",    hex_prism_ibo);
+    if (hex_instance_vbo) asset_manager->register_buffer("hex_instance_vbo", hex_instance_vbo);
     if (lava_vbo)    asset_manager->register_buffer("lava_vbo",    lava_vbo);
     if (lava_ibo)    asset_manager->register_buffer("lava_ibo",    lava_ibo);
     if (contour_vbo) asset_manager->register_buffer("contour_vbo", contour_vbo);
+    if (contour_ibo) asset_manager->register_buffer("contour_ibo", contour_ibo);
   }
 
+  geometry_buffer_bytes = 0;
+  if (basalt_vbo)       geometry_buffer_bytes += basalt_vbo_sz + basalt_ibo_sz;
+  if (hex_instance_vbo) geometry_buffer_bytes += prism_vbo_sz + prism_ibo_sz + instance_vbo_sz;
+  if (lava_vbo)         geometry_buffer_bytes += lava_vbo_sz;
+  if (lava_ibo)         geometry_buffer_bytes += lava_ibo_sz;
+  if (contour_vbo)      geometry_buffer_bytes += contour_vbo_sz + contour_ibo_sz;
+
   has_data = true;
-  SDL_Log("TerrainRenderer: Mesh uploaded (basalt=%u idx, lava=%u verts/%u idx, contour=%u verts) staging=%u bytes",
-          basalt_total_index_count, lava_vertex_count, lava_index_count,
-          contour_vertex_count, total_sz);
+  SDL_Log("TerrainRenderer: Mesh uploaded (basalt=%u idx, %u hex instances, lava=%u verts/%u idx, contour=%u verts/%u idx) staging=%u bytes, geometry=%u bytes%s",
+          basalt_total_index_count, hex_instance_count, lava_vertex_count, lava_index_count,
+          contour_vertex_count, contour_index_count, total_sz, geometry_buffer_bytes,
+          compact ? " (compact)" : "");
+}
+
+
+
+
+void TerrainRenderer::upload_to_buffer(SDL_GPUCommandBuffer *cmd,
+                                       UploadManager &uploader,
+                                       SDL_GPUBuffer *buffer, uint32_t offset,
+                                       const void *data, uint32_t size, bool cycle) {
+  uint32_t src_offset = 0;
+  void *dst_ptr       = uploader.alloc(size, &src_offset);
+
+  SDL_GPUTransferBuffer *transfer = nullptr;
+  if (!dst_ptr) {
+    // UploadManager overflow — fall back to a one-shot transfer buffer.
+    SDL_GPUTransferBufferCreateInfo ti = {};
+    ti.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    ti.size  = size;
+    transfer = SDL_CreateGPUTransferBuffer(gpu_device, &ti);
+    if (!transfer) return;
+    dst_ptr = SDL_MapGPUTransferBuffer(gpu_device, transfer, false);
+    if (!dst_ptr) { SDL_ReleaseGPUTransferBuffer(gpu_device, transfer); return; }
+  }
+  SDL_memcpy(dst_ptr, data, size);
+  if (transfer) SDL_UnmapGPUTransferBuffer(gpu_device, transfer);
+
+  SDL_GPUCopyPass *copy = SDL_BeginGPUCopyPass(cmd);
+  SDL_GPUTransferBufferLocation src = { transfer ? transfer : uploader.buffer,
+                                        transfer ? 0u : src_offset };
+  SDL_GPUBufferRegion           dst_reg = { buffer, offset, size };
+  SDL_UploadToGPUBuffer(copy, &src, &dst_reg, cycle);
+  SDL_EndGPUCopyPass(copy);
+  if (transfer) SDL_ReleaseGPUTransferBuffer(gpu_device, transfer);
+}
+
+void TerrainRenderer::update_lava_vertices(SDL_GPUCommandBuffer *cmd,
+                                           UploadManager &uploader,
+                                           const std::vector<GpuLavaVertex> &verts) {
+  if (!lava_vbo || verts.size() != lava_vertex_count) return;
+  // cycle=true: last frame's draw may still be reading the buffer.
+  if (compact) {
+    packed_lava.resize(verts.size());
+    pack_lava_vertices(verts, packing, packed_lava.data());
+    upload_to_buffer(cmd, uploader, lava_vbo, 0, packed_lava.data(),
+                     (uint32_t)(packed_lava.size() * sizeof(PackedLavaVertex)), true);
+    return;
+  }
+  upload_to_buffer(cmd, uploader, lava_vbo, 0, verts.data(),
+                   (uint32_t)(verts.size() * sizeof(GpuLavaVertex)), true);
+}
+
+void TerrainRenderer::update_hex_instances(SDL_GPUCommandBuffer *cmd,
+                                           UploadManager &uploader,
+                                           std::span<const GpuHexInstance> instances,
+                                           uint32_t first) {
+  if (!hex_instance_vbo || instances.empty() ||
+      first + instances.size() > hex_instance_count)
+    return;
+  // No cycling: a partial write has to keep the rest of the buffer.
+  upload_to_buffer(cmd, uploader, hex_instance_vbo,
+                   first * (uint32_t)sizeof(GpuHexInstance), instances.data(),
+                   (uint32_t)instances.size_bytes(), false);
 }
 
 
@@ -705,23 +1042,7 @@ void TerrainRenderer::rebuild_clusters_if_needed(SDL_GPUCommandBuffer *cmd,
 void TerrainRenderer::stage_geometry(SDL_GPURenderPass *pass,
                                       SDL_GPUCommandBuffer *cmd,
                                       const SceneUniforms &uniforms) {
-  if (!basalt_vbo || !basalt_ibo || basalt_total_index_count == 0) return;
-
-  SDL_BindGPUGraphicsPipeline(pass, terrain_pipeline);
-  SDL_PushGPUVertexUniformData(cmd, 0, &uniforms, sizeof(uniforms));
-  SDL_PushGPUFragmentUniformData(cmd, 0, &uniforms, sizeof(uniforms));
-
-  if (point_light_ssbo && light_grid_ssbo && global_index_ssbo) {
-    SDL_GPUBuffer *storage_bufs[3] = {
-        point_light_ssbo, light_grid_ssbo, global_index_ssbo };
-    SDL_BindGPUFragmentStorageBuffers(pass, 0, storage_bufs, 3);
-  }
-
-  SDL_GPUBufferBinding vbind = { basalt_vbo, 0 };
-  SDL_GPUBufferBinding ibind = { basalt_ibo, 0 };
-  SDL_BindGPUVertexBuffers(pass, 0, &vbind, 1);
-  SDL_BindGPUIndexBuffer(pass, &ibind, SDL_GPU_INDEXELEMENTSIZE_32BIT);
-  SDL_DrawGPUIndexedPrimitives(pass, basalt_total_index_count, 1, 0, 0, 0);
+  draw_basalt(pass, cmd, uniforms);
 }
 
 
@@ -808,49 +1129,142 @@ void TerrainRenderer::stage_cull_lights(SDL_GPUCommandBuffer *cmd,
 
 
 
-void TerrainRenderer::stage_shaded_draw(SDL_GPURenderPass *pass,
-                                         SDL_GPUCommandBuffer *cmd,
-                                         const SceneUniforms &uniforms) {
-
-  if (basalt_vbo && basalt_ibo && basalt_total_index_count > 0 && terrain_pipeline) {
-    SDL_BindGPUGraphicsPipeline(pass, terrain_pipeline);
-    SDL_PushGPUVertexUniformData(cmd, 0, &uniforms, sizeof(uniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 0, &uniforms, sizeof(uniforms));
-
-    {
-      SDL_GPUBuffer *frag_storage[3] = {
-        point_light_ssbo  ? point_light_ssbo  : dummy_ssbo,
-        light_grid_ssbo   ? light_grid_ssbo   : dummy_ssbo,
-        global_index_ssbo ? global_index_ssbo : dummy_ssbo,
-      };
-      SDL_BindGPUFragmentStorageBuffers(pass, 0, frag_storage, 3);
+void TerrainRenderer::cull_tiles(const SceneUniforms &uniforms) {
+  // Orthographic camera: clip w stays 1, so a tile is visible when the clip
+  // space rectangle of its bounds' corners overlaps [-1, 1]^2.
+  glm::mat4 view_proj = uniforms.projection * uniforms.view;
+  visible_tiles = 0;
+  for (size_t t = 0; t < tile_bounds.size(); ++t) {
+    const auto &b = tile_bounds[t];
+    tile_visible[t] = 0;
+    if (b.min_x > b.max_x)
+      continue;
+    float lo_x = FLT_MAX, lo_y = FLT_MAX, hi_x = -FLT_MAX, hi_y = -FLT_MAX;
+    for (int c = 0; c < 8; ++c) {
+      glm::vec4 p = view_proj * glm::vec4((c & 1) ? b.max_x : b.min_x,
+                                          (c & 2) ? b.max_y : b.min_y,
+                                          (c & 4) ? b.max_z : b.min_z, 1.0f);
+      lo_x = std::min(lo_x, p.x);
+      hi_x = std::max(hi_x, p.x);
+      lo_y = std::min(lo_y, p.y);
+      hi_y = std::max(hi_y, p.y);
+    }
+    if (hi_x >= -1.0f && lo_x <= 1.0f && hi_y >= -1.0f && lo_y <= 1.0f) {
+      tile_visible[t] = 1;
+      visible_tiles++;
     }
+  }
+}
 
+void TerrainRenderer::bind_lava_glow(SDL_GPURenderPass *pass) {
+  SDL_GPUTextureSamplerBinding binding = { lava_glow_texture, lava_glow_sampler };
+  SDL_BindGPUFragmentSamplers(pass, 0, &binding, 1);
+}
+
+// Baked columns when the mesh carried them, otherwise one instanced draw of
+// the hex prism.
+void TerrainRenderer::draw_basalt(SDL_GPURenderPass *pass, SDL_GPUCommandBuffer *cmd,
+                                  const SceneUniforms &uniforms) {
+  SDL_GPUGraphicsPipeline *baked_pipeline = compact ? terrain_packed_pipeline : terrain_pipeline;
+  bool baked     = basalt_vbo && basalt_ibo && basalt_total_index_count > 0 && baked_pipeline;
+  bool instanced = hex_prism_vbo && hex_prism_ibo && hex_instance_vbo &&
+                   hex_instance_count > 0 && hex_column_pipeline;
+  if ((!baked && !instanced) || !lava_glow_texture || !lava_glow_sampler) return;
+
+  SDL_BindGPUGraphicsPipeline(pass, baked ? baked_pipeline : hex_column_pipeline);
+  SDL_PushGPUVertexUniformData(cmd, 0, &uniforms, sizeof(uniforms));
+  SDL_PushGPUFragmentUniformData(cmd, 0, &uniforms, sizeof(uniforms));
+
+  {
+    SDL_GPUBuffer *frag_storage[3] = {
+      point_light_ssbo  ? point_light_ssbo  : dummy_ssbo,
+      light_grid_ssbo   ? light_grid_ssbo   : dummy_ssbo,
+      global_index_ssbo ? global_index_ssbo : dummy_ssbo,
+    };
+    SDL_BindGPUFragmentStorageBuffers(pass, 0, frag_storage, 3);
+  }
+  bind_lava_glow(pass);
+
+  if (baked) {
     SDL_GPUBufferBinding vbind = { basalt_vbo, 0 };
     SDL_GPUBufferBinding ibind = { basalt_ibo, 0 };
     SDL_BindGPUVertexBuffers(pass, 0, &vbind, 1);
-    SDL_BindGPUIndexBuffer(pass, &ibind, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+    SDL_BindGPUIndexBuffer(pass, &ibind, basalt_index_size);
     SDL_DrawGPUIndexedPrimitives(pass, basalt_total_index_count, 1, 0, 0, 0);
+    return;
   }
+  SDL_GPUBufferBinding vbinds[2] = { { hex_prism_vbo, 0 }, { hex_instance_vbo, 0 } };
+  SDL_GPUBufferBinding ibind     = { hex_prism_ibo, 0 };
+  SDL_BindGPUVertexBuffers(pass, 0, vbinds, 2);
+  SDL_BindGPUIndexBuffer(pass, &ibind, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+  SDL_DrawGPUIndexedPrimitives(pass, hex_prism_index_count, hex_instance_count, 0, 0, 0);
+}
 
+void TerrainRenderer::draw_visible_tiles(SDL_GPURenderPass *pass,
+                                         const TerrainMesh::IndexRange *ranges) {
+  // Tiles are stored in order, so runs of visible tiles collapse into one draw.
+  uint32_t first = 0, count = 0;
+  for (size_t t = 0; t < tile_bounds.size(); ++t) {
+    if (!tile_visible[t] || ranges[t].count == 0)
+      continue;
+    if (count > 0 && ranges[t].first == first + count) {
+      count += ranges[t].count;
+      continue;
+    }
+    if (count > 0)
+      SDL_DrawGPUIndexedPrimitives(pass, count, 1, first, 0, 0);
+    first = ranges[t].first;
+    count = ranges[t].count;
+  }
+  if (count > 0)
+    SDL_DrawGPUIndexedPrimitives(pass, count, 1, first, 0, 0);
+}
+
+void TerrainRenderer::stage_shaded_draw(SDL_GPURenderPass *pass,
+                                         SDL_GPUCommandBuffer *cmd,
+                                         const SceneUniforms &uniforms) {
+  if (!tile_bounds.empty())
+    cull_tiles(uniforms);
+
+  draw_basalt(pass, cmd, uniforms);
 
-  if (lava_vbo && lava_ibo && lava_index_count > 0 && lava_pipeline) {
-    SDL_BindGPUGraphicsPipeline(pass, lava_pipeline);
+
+  SDL_GPUGraphicsPipeline *lava_pipe = compact ? lava_packed_pipeline : lava_pipeline;
+  if (lava_vbo && lava_ibo && lava_index_count > 0 && lava_pipe) {
+    SDL_BindGPUGraphicsPipeline(pass, lava_pipe);
     SDL_PushGPUVertexUniformData(cmd, 0, &uniforms, sizeof(uniforms));
     SDL_GPUBufferBinding vbind = { lava_vbo, 0 };
     SDL_GPUBufferBinding ibind = { lava_ibo, 0 };
     SDL_BindGPUVertexBuffers(pass, 0, &vbind, 1);
-    SDL_BindGPUIndexBuffer(pass, &ibind, SDL_GPU_INDEXELEMENTSIZE_32BIT);
-    SDL_DrawGPUIndexedPrimitives(pass, lava_index_count, 1, 0, 0, 0);
+    SDL_BindGPUIndexBuffer(pass, &ibind, lava_index_size);
+    if (lava_tile_ranges.size() == tile_bounds.size() && !tile_bounds.empty())
+      draw_visible_tiles(pass, lava_tile_ranges.data());
+    else
+      SDL_DrawGPUIndexedPrimitives(pass, lava_index_count, 1, 0, 0, 0);
   }
 
 
-  if (contour_vbo && contour_vertex_count > 0 && contour_pipeline) {
-    SDL_BindGPUGraphicsPipeline(pass, contour_pipeline);
+  SDL_GPUGraphicsPipeline *contour_pipe = compact ? contour_packed_pipeline : contour_pipeline;
+  if (contour_vbo && contour_ibo && contour_index_count > 0 && contour_pipe) {
+    SDL_BindGPUGraphicsPipeline(pass, contour_pipe);
     SDL_PushGPUVertexUniformData(cmd, 0, &uniforms, sizeof(uniforms));
     SDL_GPUBufferBinding vbind = { contour_vbo, 0 };
+    SDL_GPUBufferBinding ibind = { contour_ibo, 0 };
     SDL_BindGPUVertexBuffers(pass, 0, &vbind, 1);
-    SDL_DrawGPUPrimitives(pass, contour_vertex_count, 1, 0, 0);
+    SDL_BindGPUIndexBuffer(pass, &ibind, contour_index_size);
+    if (contour_lod_ranges.empty()) {
+      SDL_DrawGPUIndexedPrimitives(pass, contour_index_count, 1, 0, 0, 0);
+    } else {
+      int lod = std::min(contour_lod, (int)contour_lod_ranges.size() - 1);
+      size_t tile_count = tile_bounds.size();
+      if (tile_count > 0 && contour_tile_ranges.size() >= (lod + 1) * tile_count) {
+        draw_visible_tiles(pass, &contour_tile_ranges[lod * tile_count]);
+      } else {
+        const auto &range = contour_lod_ranges[lod];
+        if (range.count > 0)
+          SDL_DrawGPUIndexedPrimitives(pass, range.count, 1, range.first, 0, 0);
+      }
+    }
   }
 }
 
@@ -868,9 +1282,20 @@ void TerrainRenderer::draw(SDL_GPUCommandBuffer *cmd,
   upload_lights(cmd, uploader, lights);
   stage_cull_lights(cmd, uniforms, lights);
 
+  // Compact buffers decode positions against the mesh's packing box.
+  SceneUniforms u = uniforms;
+  if (compact) {
+    u.pack_origin_x = packing.origin_x;
+    u.pack_origin_y = packing.origin_y;
+    u.pack_origin_z = packing.origin_z;
+    u.pack_extent_x = packing.extent_x;
+    u.pack_extent_y = packing.extent_y;
+    u.pack_extent_z = packing.extent_z;
+  }
+
   SDL_GPURenderPass *pass = begin_render_pass_load(cmd, swapchain, w, h);
   if (!pass) return;
-  stage_shaded_draw(pass, cmd, uniforms);
+  stage_shaded_draw(pass, cmd, u);
   SDL_EndGPURenderPass(pass);
 }
 
@@ -973,10 +1398,24 @@ void TerrainRenderer::release_buffers(SDL_GPUDevice *device) {
   };
   rel(basalt_vbo,  "basalt_vbo");
   rel(basalt_ibo,  "basalt_ibo");
+  rel(hex_prism_vbo,    "hex_prism_vbo");
+  rel(hex_prism_ibo,    "hex_prism_ibo");
+  rel(hex_instance_vbo, "hex_instance_vbo");
+  hex_prism_index_count = 0;
+  hex_instance_count    = 0;
   rel(lava_vbo,    "lava_vbo");
   rel(lava_ibo,    "lava_ibo");
   rel(contour_vbo, "contour_vbo");
+  rel(contour_ibo, "contour_ibo");
+  geometry_buffer_bytes = 0;
+  contour_lod_ranges.clear();
+  tile_bounds.clear();
+  lava_tile_ranges.clear();
+  contour_tile_ranges.clear();
+  tile_visible.clear();
+  visible_tiles = 0;
   if (void_vbo) { SDL_ReleaseGPUBuffer(device, void_vbo); void_vbo = nullptr; }
+  if (lava_glow_texture) { SDL_ReleaseGPUTexture(device, lava_glow_texture); lava_glow_texture = nullptr; }
   has_data = false;
 }
 
@@ -1006,10 +1445,15 @@ void TerrainRenderer::cleanup(SDL_GPUDevice *device) {
 
   if (dummy_ssbo)               { SDL_ReleaseGPUBuffer(device, dummy_ssbo);                           dummy_ssbo               = nullptr; }
   if (depth_texture)            { SDL_ReleaseGPUTexture(device, depth_texture);                        depth_texture            = nullptr; }
+  if (lava_glow_sampler)        { SDL_ReleaseGPUSampler(device, lava_glow_sampler);                    lava_glow_sampler        = nullptr; }
   if (terrain_pipeline)         { SDL_ReleaseGPUGraphicsPipeline(device, terrain_pipeline);            terrain_pipeline         = nullptr; }
   if (terrain_stencil_pipeline) { SDL_ReleaseGPUGraphicsPipeline(device, terrain_stencil_pipeline);   terrain_stencil_pipeline = nullptr; }
+  if (hex_column_pipeline)      { SDL_ReleaseGPUGraphicsPipeline(device, hex_column_pipeline);         hex_column_pipeline      = nullptr; }
   if (lava_pipeline)            { SDL_ReleaseGPUGraphicsPipeline(device, lava_pipeline);               lava_pipeline            = nullptr; }
   if (contour_pipeline)         { SDL_ReleaseGPUGraphicsPipeline(device, contour_pipeline);            contour_pipeline         = nullptr; }
+  if (terrain_packed_pipeline)  { SDL_ReleaseGPUGraphicsPipeline(device, terrain_packed_pipeline);     terrain_packed_pipeline  = nullptr; }
+  if (lava_packed_pipeline)     { SDL_ReleaseGPUGraphicsPipeline(device, lava_packed_pipeline);        lava_packed_pipeline     = nullptr; }
+  if (contour_packed_pipeline)  { SDL_ReleaseGPUGraphicsPipeline(device, contour_packed_pipeline);     contour_packed_pipeline  = nullptr; }
   if (cluster_gen_pipeline)     { SDL_ReleaseGPUComputePipeline(device, cluster_gen_pipeline);         cluster_gen_pipeline     = nullptr; }
   if (light_culling_pipeline)   { SDL_ReleaseGPUComputePipeline(device, light_culling_pipeline);       light_culling_pipeline   = nullptr; }
   // Shaders are owned by AssetManager and released via asset_manager.clear().
@@ -3,14 +3,37 @@
 #include "core/asset_manager.h"
 #include "gpu/gpu.h"
 #include <SDL3/SDL.h>
+#include <span>
+#include <string>
 #include <vector>
 
 class TerrainRenderer {
 public:
   void init(SDL_GPUDevice *device, SDL_Window *window, AssetManager &am);
   void upload_mesh(SDL_GPUDevice *device, const TerrainMesh &mesh);
+  // Overwrites the lava vertex buffer; verts must match the uploaded mesh's
+  // lava vertex count. Call outside a render pass.
+  void update_lava_vertices(SDL_GPUCommandBuffer *cmd, UploadManager &uploader,
+                            const std::vector<GpuLavaVertex> &verts);
+  // Overwrites instances [first, first + instances.size()) of the hex column
+  // instance buffer, e.g. after a recolour. Call outside a render pass.
+  void update_hex_instances(SDL_GPUCommandBuffer *cmd, UploadManager &uploader,
+                            std::span<const GpuHexInstance> instances, uint32_t first = 0);
   void rebuild_dirty_pipelines(SDL_Window *window);
 
+  // Picks the contour LOD level drawn by the next draw() from camera zoom.
+  void select_contour_lod(float zoom);
+  int current_contour_lod() const { return contour_lod; }
+
+  // Geometry tiles that passed the last frustum cull.
+  uint32_t visible_tile_count() const { return visible_tiles; }
+  uint32_t tile_count() const { return (uint32_t)tile_bounds.size(); }
+
+  // Bytes of vertex and index buffers uploaded by the last upload_mesh, and
+  // whether they used the compact formats.
+  uint32_t geometry_bytes() const { return geometry_buffer_bytes; }
+  bool     compact_vertices() const { return compact; }
+
 
 
   void draw(SDL_GPUCommandBuffer *cmd,
@@ -69,6 +92,11 @@ private:
 
   void init_graphics_pipelines(SDL_GPUDevice *device, SDL_Window *window);
   void init_compute_pipelines(SDL_GPUDevice *device);
+  SDL_GPUGraphicsPipeline *build_hex_column_pipeline(SDL_GPUTextureFormat swapchain_format);
+  // name is "terrain", "lava" or "contour": the float pipeline of that name
+  // with <name>_packed.vert and the matching Packed* vertex layout.
+  SDL_GPUGraphicsPipeline *build_packed_pipeline(const std::string &name,
+                                                 SDL_GPUTextureFormat swapchain_format);
   void init_cluster_buffers(SDL_GPUDevice *device, uint32_t tilesX, uint32_t tilesY, uint32_t num_slices);
 
 
@@ -81,6 +109,15 @@ private:
                          const SceneUniforms &uniforms);
 
 
+  void cull_tiles(const SceneUniforms &uniforms);
+  void draw_visible_tiles(SDL_GPURenderPass *pass, const TerrainMesh::IndexRange *ranges);
+  void bind_lava_glow(SDL_GPURenderPass *pass);
+  void draw_basalt(SDL_GPURenderPass *pass, SDL_GPUCommandBuffer *cmd,
+                   const SceneUniforms &uniforms);
+  void upload_to_buffer(SDL_GPUCommandBuffer *cmd, UploadManager &uploader,
+                        SDL_GPUBuffer *buffer, uint32_t offset,
+                        const void *data, uint32_t size, bool cycle);
+
   void release_buffers(SDL_GPUDevice *device);
   void release_cluster_buffers(SDL_GPUDevice *device);
   void upload_lights(SDL_GPUCommandBuffer *cmd,
@@ -99,19 +136,40 @@ private:
 
   SDL_GPUGraphicsPipeline *terrain_pipeline         = nullptr;
   SDL_GPUGraphicsPipeline *terrain_stencil_pipeline = nullptr;
+  SDL_GPUGraphicsPipeline *hex_column_pipeline      = nullptr;
   SDL_GPUGraphicsPipeline *lava_pipeline            = nullptr;
   SDL_GPUGraphicsPipeline *contour_pipeline         = nullptr;
+  SDL_GPUGraphicsPipeline *terrain_packed_pipeline  = nullptr;
+  SDL_GPUGraphicsPipeline *lava_packed_pipeline     = nullptr;
+  SDL_GPUGraphicsPipeline *contour_packed_pipeline  = nullptr;
 
 
   SDL_GPUComputePipeline  *cluster_gen_pipeline     = nullptr;
   SDL_GPUComputePipeline  *light_culling_pipeline   = nullptr;
 
 
+  // Set from TerrainMesh::compact_vertices at upload: basalt, lava and
+  // contour buffers hold Packed* vertices quantised over packing.
+  bool                    compact = false;
+  VertexPacking           packing;
+  SDL_GPUIndexElementSize basalt_index_size  = SDL_GPU_INDEXELEMENTSIZE_32BIT;
+  SDL_GPUIndexElementSize lava_index_size    = SDL_GPU_INDEXELEMENTSIZE_32BIT;
+  SDL_GPUIndexElementSize contour_index_size = SDL_GPU_INDEXELEMENTSIZE_32BIT;
+  std::vector<PackedLavaVertex> packed_lava; // update_lava_vertices scratch
+  uint32_t                geometry_buffer_bytes = 0;
+
   SDL_GPUBuffer *basalt_vbo = nullptr;
   SDL_GPUBuffer *basalt_ibo = nullptr;
   uint32_t       basalt_side_index_count  = 0;
   uint32_t       basalt_total_index_count = 0;
 
+  // Instanced basalt: one hex prism drawn once per column.
+  SDL_GPUBuffer *hex_prism_vbo    = nullptr;
+  SDL_GPUBuffer *hex_prism_ibo    = nullptr;
+  SDL_GPUBuffer *hex_instance_vbo = nullptr;
+  uint32_t       hex_prism_index_count = 0;
+  uint32_t       hex_instance_count    = 0;
+
   SDL_GPUBuffer *lava_vbo       = nullptr;
   SDL_GPUBuffer *lava_ibo       = nullptr;
   uint32_t       lava_vertex_count = 0;
@@ -120,8 +178,21 @@ private:
   SDL_GPUBuffer *void_vbo       = nullptr;
   uint32_t       void_vertex_count = 0;
 
+  SDL_GPUTexture *lava_glow_texture = nullptr; // R8, see TerrainMesh::lava_glow
+  SDL_GPUSampler *lava_glow_sampler = nullptr;
+
   SDL_GPUBuffer *contour_vbo    = nullptr;
+  SDL_GPUBuffer *contour_ibo    = nullptr;
   uint32_t       contour_vertex_count = 0;
+  uint32_t       contour_index_count  = 0;
+  std::vector<TerrainMesh::IndexRange> contour_lod_ranges;
+  int            contour_lod = 0;
+
+  std::vector<TerrainMesh::TileBounds> tile_bounds;
+  std::vector<TerrainMesh::IndexRange> lava_tile_ranges;
+  std::vector<TerrainMesh::IndexRange> contour_tile_ranges;
+  std::vector<uint8_t>                 tile_visible;
+  uint32_t                             visible_tiles = 0;
 
 
   SDL_GPUBuffer *point_light_ssbo   = nullptr;
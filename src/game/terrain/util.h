@@ -9,3 +9,17 @@ inline uint32_t hash2d(int x, int y) {
 inline uint32_t hash1d(int idx) {
   return (idx * 374761393u) ^ 668265263u;
 }
+
+// SplitMix64 finaliser. Used as a counter-based RNG: hashing (key, counter)
+// gives each draw directly, so draws can happen in any order or in parallel.
+inline uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Uniform float in [0, 1) from the top 24 bits of a hash.
+inline float hash_to_unit(uint64_t h) {
+  return (float)(h >> 40) * (1.0f / 16777216.0f);
+}
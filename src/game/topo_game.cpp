@@ -30,13 +30,19 @@ static json params_to_json(const ElevationParams &elev,
     }},
     {"composition", {
       {"void_chance",    comp.void_chance},
+      {"smooth_lava_shore", comp.smooth_lava_shore},
       {"terrace_levels", comp.terrace_levels},
       {"min_region_size",comp.min_region_size}
     }},
     {"terrain", {
       {"use_isometric",  ts.use_isometric},
       {"current_palette",ts.current_palette},
-      {"map_scale",      ts.map_scale}
+      {"map_scale",      ts.map_scale},
+      {"lava_point_lights", ts.lava_point_lights},
+      {"lava_light_budget", ts.lava_light_budget},
+      {"instanced_columns", ts.instanced_columns},
+      {"compact_vertices", ts.compact_vertices},
+      {"lava_flow",      ts.lava_flow}
     }}
   };
 }
@@ -65,6 +71,7 @@ static void json_to_params(const json &j, ElevationParams &elev,
   if (j.contains("composition")) {
     auto &c = j["composition"];
     if (c.contains("void_chance"))     comp.void_chance     = c["void_chance"];
+    if (c.contains("smooth_lava_shore")) comp.smooth_lava_shore = c["smooth_lava_shore"];
     if (c.contains("terrace_levels"))  comp.terrace_levels  = c["terrace_levels"];
     if (c.contains("min_region_size")) comp.min_region_size = c["min_region_size"];
   }
@@ -73,6 +80,11 @@ static void json_to_params(const json &j, ElevationParams &elev,
     if (t.contains("use_isometric"))   ts.use_isometric   = t["use_isometric"];
     if (t.contains("current_palette")) ts.current_palette = t["current_palette"];
     if (t.contains("map_scale"))       ts.map_scale       = t["map_scale"];
+    if (t.contains("lava_point_lights")) ts.lava_point_lights = t["lava_point_lights"];
+    if (t.contains("lava_light_budget")) ts.lava_light_budget = t["lava_light_budget"];
+    if (t.contains("instanced_columns")) ts.instanced_columns = t["instanced_columns"];
+    if (t.contains("compact_vertices"))  ts.compact_vertices  = t["compact_vertices"];
+    if (t.contains("lava_flow"))       ts.lava_flow       = t["lava_flow"];
   }
 }
 
@@ -169,6 +181,16 @@ void TopoGame::on_pre_frame_game(GpuContext &gpu, flecs::world &ecs) {
     // No frame command buffer is open here, so SDL_WaitForGPUIdle inside
     // upload_mesh is safe.
     terrain_renderer.upload_mesh(gpu.device, *ready_mesh_pending);
+    lava_lights = std::move(ready_mesh_pending->lava_lights);
+    lava_vertices = std::move(ready_mesh_pending->lava_vertices);
+    lava_base_z.resize(lava_vertices.size());
+    for (size_t i = 0; i < lava_vertices.size(); ++i)
+      lava_base_z[i] = lava_vertices[i].pos_z;
+    lava_raised = false;
+    hex_instances          = std::move(ready_mesh_pending->hex_instances);
+    hex_palette            = -1;
+    baked_basalt_bytes     = ready_mesh_pending->baked_basalt_bytes;
+    instanced_basalt_bytes = ready_mesh_pending->instanced_basalt_bytes;
 
     auto *map_data = ecs.get_mut<MapData>();
     auto *contours = ecs.get_mut<ContourData>();
@@ -184,6 +206,7 @@ void TopoGame::on_pre_frame_game(GpuContext &gpu, flecs::world &ecs) {
       *map_data = std::move(*ready_map_pending);
       if (contours && ready_contours_pending)
         *contours = std::move(*ready_contours_pending);
+      lava_flow.init(*map_data);
     }
 
     ready_mesh_pending.reset();
@@ -274,10 +297,16 @@ void TopoGame::on_render_game(GpuContext &gpu, FrameContext &frame, flecs::world
       int  current_palette;
       float map_scale;
       float contour_opacity;
+      float contour_tolerance;
+      int lava_light_budget;
+      bool instanced_columns;
+      bool compact_vertices;
       bool need_regenerate;
     };
     TsSnap ts_snap { ts->use_isometric, ts->current_palette,
-                     ts->map_scale, ts->contour_opacity, false };
+                     ts->map_scale, ts->contour_opacity,
+                     ts->contour_tolerance, ts->lava_light_budget,
+                     ts->instanced_columns, ts->compact_vertices, false };
 
     task_system.enqueue([this, elev_snap, river_snap, worley_snap, comp_snap, ts_snap]() {
       SDL_Log("Async regen: started");
@@ -290,9 +319,12 @@ void TopoGame::on_render_game(GpuContext &gpu, FrameContext &frame, flecs::world
       compose_layers(*md, elev_snap, river_snap, worley_snap, comp_snap, nullptr);
       md->columns = generate_basalt_columns_v2(*md, Config::HEX_SIZE);
 
-      auto fill = generate_lava_and_void(*md, comp_snap.void_chance, worley_snap.seed);
+      auto fill = generate_lava_and_void(*md, comp_snap.void_chance, worley_snap.seed,
+                                         comp_snap.smooth_lava_shore);
       md->lava_bodies = std::move(fill.lava_bodies);
       md->void_bodies = std::move(fill.void_bodies);
+      md->body_runs = std::move(fill.runs);
+      md->body_labels = std::move(fill.labels);
 
       auto cd = std::make_shared<ContourData>();
       int n = Config::MAP_WIDTH * Config::MAP_HEIGHT;
@@ -301,14 +333,22 @@ void TopoGame::on_render_game(GpuContext &gpu, FrameContext &frame, flecs::world
       float interval = 1.0f / comp_snap.terrace_levels;
       extract_contours(cd->heightmap, Config::MAP_WIDTH, Config::MAP_HEIGHT,
                        interval, cd->contour_lines, cd->band_map);
-      simplify_contours(cd->contour_lines, 0.5f);
+      ContourPolylines stitched;
+      stitch_contours(cd->contour_lines, stitched);
+      build_contour_lods(stitched, ts_snap.contour_tolerance,
+                         Config::CONTOUR_LOD_LEVELS, cd->polyline_lods);
 
-      // Reconstruct a TerrainState for build_terrain_mesh (reads only current_palette).
+      // Reconstruct a TerrainState for build_terrain_mesh (reads current_palette,
+      // lava_light_budget, instanced_columns and compact_vertices).
       TerrainState ts_for_build;
       ts_for_build.use_isometric   = ts_snap.use_isometric;
       ts_for_build.current_palette = ts_snap.current_palette;
       ts_for_build.map_scale       = ts_snap.map_scale;
       ts_for_build.contour_opacity = ts_snap.contour_opacity;
+      ts_for_build.contour_tolerance = ts_snap.contour_tolerance;
+      ts_for_build.lava_light_budget = ts_snap.lava_light_budget;
+      ts_for_build.instanced_columns = ts_snap.instanced_columns;
+      ts_for_build.compact_vertices  = ts_snap.compact_vertices;
       ts_for_build.need_regenerate = false;
 
       auto mesh = std::make_shared<TerrainMesh>(build_terrain_mesh(ts_for_build, *md, *cd));
@@ -345,23 +385,42 @@ void TopoGame::on_render_game(GpuContext &gpu, FrameContext &frame, flecs::world
 
   CameraMatrices cam_mats = camera_system.build_matrices(camera, aspect);
 
+  // Lava is lit either by the baked glow field (TerrainMesh::lava_glow) or
+  // by the clustered lights placed at generation time.
   point_lights.clear();
-  if (map_data) {
-    const float inv = 1.0f / Config::HEX_SIZE;
-    for (const auto &lava : map_data->lava_bodies) {
-      if (lava.pixels.empty()) continue;
-      float cx = (lava.min_x + lava.max_x) * 0.5f * inv;
-      float cy = (lava.min_y + lava.max_y) * 0.5f * inv;
-      GpuPointLight pl;
-      pl.pos_x     = cx;
-      pl.pos_y     = cy;
-      pl.pos_z     = lava.height + 1.0f;
-      pl.radius    = 40.0f;
-      pl.color_r   = 1.0f;
-      pl.color_g   = 0.35f;
-      pl.color_b   = 0.05f;
-      pl.intensity = 3.0f;
-      point_lights.push_back(pl);
+  if (ts && ts->lava_point_lights)
+    point_lights = lava_lights;
+
+  // Step the lava flow and raise the lava surface by its depth; when the sim
+  // is switched off, drop the surface back to the generated heights once.
+  if (ts && terrain_renderer.has_mesh()) {
+    bool refresh = false;
+    if (ts->lava_flow) {
+      refresh = lava_flow.step(ecs.delta_time()) || !lava_raised;
+      lava_raised = true;
+    } else if (lava_raised) {
+      refresh = true;
+      lava_raised = false;
+    }
+    if (refresh) {
+      for (size_t i = 0; i < lava_vertices.size(); ++i) {
+        GpuLavaVertex &v = lava_vertices[i];
+        v.pos_z = lava_base_z[i];
+        if (lava_raised)
+          v.pos_z += lava_flow.depth_at(v.pos_x * Config::HEX_SIZE,
+                                        v.pos_y * Config::HEX_SIZE);
+      }
+      terrain_renderer.update_lava_vertices(frame.cmd, gpu.upload_manager, lava_vertices);
+    }
+  }
+
+  // Instanced columns take a palette change as a colour-only instance upload.
+  if (ts && terrain_renderer.has_mesh() && !hex_instances.empty() &&
+      hex_palette != ts->current_palette) {
+    if (const auto *md = ecs.get<MapData>(); md && md->columns.size() == hex_instances.size()) {
+      recolor_hex_instances(hex_instances, md->columns, PALETTES[ts->current_palette]);
+      terrain_renderer.update_hex_instances(frame.cmd, gpu.upload_manager, hex_instances);
+      hex_palette = ts->current_palette;
     }
   }
 
@@ -382,7 +441,10 @@ void TopoGame::on_render_game(GpuContext &gpu, FrameContext &frame, flecs::world
         terrain_renderer.cluster_tiles_x(), terrain_renderer.cluster_tiles_y(),
         time, ts->contour_opacity,
         (uint32_t)point_lights.size());
+    if (ts->lava_point_lights)
+      uniforms.glow_intensity = 0.0f;
 
+    terrain_renderer.select_contour_lod(camera.zoom);
     terrain_renderer.draw(frame.cmd, frame.swapchain,
                           frame.swapchain_w, frame.swapchain_h,
                           uniforms, point_lights,
@@ -479,11 +541,36 @@ void TopoGame::render_ui(flecs::world &ecs, bool game_window_open) {
   ImGui::Text("Composition");
   ImGui::SliderFloat("Void Chance", &comp->void_chance, 0.0f, 1.0f);
   ts->need_regenerate |= ImGui::IsItemDeactivatedAfterEdit();
+  ts->need_regenerate |= ImGui::Checkbox("Smooth Lava Shore", &comp->smooth_lava_shore);
 
   ImGui::Separator();
   ImGui::Text("Contour Lines");
   ImGui::Text("Interval: %.4f (from %d terrace levels)",
               1.0f / comp->terrace_levels, comp->terrace_levels);
+  ImGui::SliderFloat("Simplify Tolerance", &ts->contour_tolerance, 0.0f, 3.0f);
+  ts->need_regenerate |= ImGui::IsItemDeactivatedAfterEdit();
+
+  ImGui::Separator();
+  ImGui::Text("Lava Lighting");
+  ImGui::Checkbox("Clustered Point Lights", &ts->lava_point_lights);
+  ImGui::SliderInt("Light Budget", &ts->lava_light_budget, 1, 128);
+  ts->need_regenerate |= ImGui::IsItemDeactivatedAfterEdit();
+
+  ImGui::Separator();
+  ImGui::Text("Lava Flow");
+  ImGui::Checkbox("Simulate Lava Flow", &ts->lava_flow);
+  ImGui::SameLine();
+  if (ImGui::Button("Restart Eruption")) {
+    if (const auto *md = ecs.get<MapData>())
+      lava_flow.init(*md);
+  }
+  ImGui::Text("Active tiles: %d / %d", lava_flow.updated_tile_count(),
+              lava_flow.tiles_x * lava_flow.tiles_y);
+
+  ImGui::Separator();
+  ImGui::Text("Basalt Columns");
+  ts->need_regenerate |= ImGui::Checkbox("Instanced Columns", &ts->instanced_columns);
+  ts->need_regenerate |= ImGui::Checkbox("Compact Vertices", &ts->compact_vertices);
 
   ImGui::Separator();
   ImGui::Text("Color Palette");
@@ -492,7 +579,8 @@ void TopoGame::render_ui(flecs::world &ecs, bool game_window_open) {
       bool sel = (ts->current_palette == i);
       if (ImGui::Selectable(PALETTES[i].name, sel)) {
         ts->current_palette = i;
-        ts->need_regenerate = true;
+        // Instanced columns are recoloured in place in on_render_game.
+        ts->need_regenerate |= !ts->instanced_columns;
       }
       if (sel) ImGui::SetItemDefaultFocus();
     }
@@ -544,11 +632,30 @@ void TopoGame::render_ui(flecs::world &ecs, bool game_window_open) {
   ImGui::Separator();
   ImGui::Text("Stats");
   ImGui::Text("Contour Lines: %zu", contours ? contours->contour_lines.size() : 0u);
+  if (contours) {
+    for (size_t i = 0; i < contours->polyline_lods.size(); ++i)
+      ImGui::Text("Contour LOD %zu: %zu polylines, %zu points%s", i,
+                  contours->polyline_lods[i].lines.size(),
+                  contours->polyline_lods[i].points.size(),
+                  (int)i == terrain_renderer.current_contour_lod() ? " (drawn)" : "");
+  }
   ImGui::Text("Resolution: %dx%d", Config::MAP_WIDTH, Config::MAP_HEIGHT);
   ImGui::Text("Camera: (%.1f, %.1f) zoom %.2fx", camera.world_x, camera.world_y, camera.zoom);
+  ImGui::Text("Geometry Tiles: %u / %u visible",
+              terrain_renderer.visible_tile_count(), terrain_renderer.tile_count());
 
   ImGui::Separator();
   if (ImGui::CollapsingHeader("Resources")) {
+    if (baked_basalt_bytes > 0) {
+      ImGui::Text("Basalt baked:     %.1f KB", baked_basalt_bytes / 1024.0);
+      ImGui::Text("Basalt instanced: %.1f KB (%.1fx smaller)", instanced_basalt_bytes / 1024.0,
+                  instanced_basalt_bytes ? (double)baked_basalt_bytes / instanced_basalt_bytes : 0.0);
+      ImGui::Text("Drawing %s columns", hex_instances.empty() ? "baked" : "instanced");
+    }
+    if (terrain_renderer.has_mesh())
+      ImGui::Text("Geometry buffers: %.1f KB (%s vertices)",
+                  terrain_renderer.geometry_bytes() / 1024.0,
+                  terrain_renderer.compact_vertices() ? "compact" : "float");
     asset_manager.render_debug_ui();
   }
 
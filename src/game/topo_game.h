@@ -7,6 +7,7 @@
 #include "terrain/map_data.h"
 #include "terrain/terrain_renderer.h"
 #include "terrain/terrain_mesh.h"
+#include "terrain/lava_flow.h"
 #include "core/task_system.h"
 #include "input/input.h"
 #include "camera/camera.h"
@@ -22,6 +23,20 @@ public:
   CameraState        camera;
   CameraSystem       camera_system;
   std::vector<GpuPointLight> point_lights;
+  std::vector<GpuPointLight> lava_lights; // from the uploaded TerrainMesh
+  LavaFlowSim                lava_flow;
+  // CPU copy of the uploaded lava vertices; pos_z is raised by the flow
+  // depth above lava_base_z and re-uploaded while the sim is moving.
+  std::vector<GpuLavaVertex> lava_vertices;
+  std::vector<float>         lava_base_z;
+  bool                       lava_raised = false;
+  // CPU copy of the uploaded hex column instances, recoloured in place on a
+  // palette change; hex_palette is the palette they were last coloured with
+  // (-1 after a new mesh, forcing one recolour).
+  std::vector<GpuHexInstance> hex_instances;
+  int                         hex_palette = -1;
+  size_t                      baked_basalt_bytes     = 0;
+  size_t                      instanced_basalt_bytes = 0;
   TaskSystem          task_system;
   AsyncTerrainState   async_terrain;
 
@@ -0,0 +1,13 @@
+#version 450
+
+#include "coord.glsl"
+
+// PackedContourVertex: unorm16 position.
+layout(location = 0) in vec3 in_pos;
+
+layout(location = 0) out float frag_opacity;
+
+void main() {
+    gl_Position  = projection * view * vec4(unpack_position(in_pos), 1.0);
+    frag_opacity = params1.y;
+}
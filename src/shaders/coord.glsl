@@ -8,6 +8,9 @@ layout(set = 1, binding = 0) uniform SceneUniforms {
     vec4 light_col;
     vec4 grid_params;
     vec4 depth_params;
+    vec4 glow_params;
+    vec4 pack_origin;
+    vec4 pack_extent;
 };
 
 #define TIME              params1.x
@@ -16,6 +19,15 @@ layout(set = 1, binding = 0) uniform SceneUniforms {
 #define NEAR_PLANE        depth_params.x
 #define FAR_PLANE         depth_params.y
 #define LIGHT_COUNT       uint(depth_params.z)
+#define GLOW_RADIUS       glow_params.x
+#define GLOW_INTENSITY    glow_params.y
+#define GLOW_SCALE        glow_params.zw
+
+// Packed (unorm16) vertex position back to world space; identity for float
+// vertices.
+vec3 unpack_position(vec3 p) {
+    return pack_origin.xyz + p * pack_extent.xyz;
+}
 
 #ifdef COORD_FRAGMENT_STAGE
 
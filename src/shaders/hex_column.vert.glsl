@@ -0,0 +1,53 @@
+#version 450
+
+#include "coord.glsl"
+
+// Config::HEX_DROP_RANGE: full scale of the unorm16 edge drops.
+const float HEX_DROP_RANGE = 2.0;
+
+// Unit hex prism (per vertex).
+layout(location = 0) in vec2  in_unit;    // corner offset in hex units
+layout(location = 1) in float in_top;     // 1 on the top rim, 0 at a side's foot
+layout(location = 2) in float in_face;    // side face 0-5, 6 for the top cap
+layout(location = 3) in vec3  in_normal;
+
+// GpuHexInstance (per column).
+layout(location = 4) in ivec2 inst_qr;
+layout(location = 5) in float inst_height;
+layout(location = 6) in vec4  inst_color;   // rgb, a = visible edge mask / 255
+layout(location = 7) in vec4  inst_drops_lo; // edges 0-3
+layout(location = 8) in vec2  inst_drops_hi; // edges 4-5
+
+layout(location = 0) out vec3  frag_color;
+layout(location = 1) out vec3  frag_world_pos;
+layout(location = 2) out float frag_sheen;
+layout(location = 3) out vec3  frag_normal;
+
+void main() {
+    int face = int(in_face + 0.5);
+    float sheen = 1.0;
+    float z = inst_height;
+
+    if (face < 6) {
+        uint mask = uint(inst_color.a * 255.0 + 0.5);
+        if ((mask & (1u << face)) == 0u) {
+            // Hidden edge: push the whole face outside the clip volume.
+            gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+            return;
+        }
+        float drop = face < 4 ? inst_drops_lo[face] : inst_drops_hi[face - 4];
+        z -= drop * HEX_DROP_RANGE * (1.0 - in_top);
+        sheen = 0.4;
+    }
+
+    // hex_to_pixel in world units (pixels / HEX_SIZE).
+    vec2 center = vec2(1.5 * float(inst_qr.x),
+                       1.732 * (float(inst_qr.y) + 0.5 * float(inst_qr.x)));
+    vec3 pos = vec3(center + in_unit, z);
+
+    gl_Position    = projection * view * vec4(pos, 1.0);
+    frag_color     = inst_color.rgb;
+    frag_world_pos = pos;
+    frag_sheen     = sheen;
+    frag_normal    = in_normal;
+}
@@ -0,0 +1,19 @@
+#version 450
+
+#include "coord.glsl"
+#include "lava_wave.glsl"
+
+// PackedLavaVertex: unorm16 position and wave phase.
+layout(location = 0) in vec4 in_packed;
+
+layout(location = 0) out vec3 frag_color;
+
+void main() {
+    vec3  pos = unpack_position(in_packed.xyz);
+    float z   = lava_wave_z(pos, in_packed.w * 6.283185);
+
+    gl_Position = projection * view * vec4(pos.xy, z - 0.002, 1.0);
+
+    float depth_factor = clamp(0.9 + (z - pos.z) * 2.0, 0.8, 1.1);
+    frag_color = lava_color.rgb * depth_factor;
+}
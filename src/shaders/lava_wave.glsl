@@ -0,0 +1,9 @@
+// Lava surface height under the travelling waves, shared by lava.vert and
+// lava_packed.vert. Needs coord.glsl.
+float lava_wave_z(vec3 pos, float time_offset) {
+    float t     = TIME + time_offset;
+    float wave1 = sin(pos.x * 0.3  + t)                * 0.02;
+    float wave2 = sin(pos.y * 0.21 + t * 1.3)          * 0.015;
+    float wave3 = sin((pos.x + pos.y) * 0.15 + t * 0.8) * 0.01;
+    return pos.z + wave1 + wave2 + wave3;
+}
@@ -15,10 +15,14 @@ struct PointLight {
     vec4 colorIntensity;
 };
 
-layout(set = 2, binding = 0) readonly buffer LightBuffer {
+layout(set = 2, binding = 0) uniform sampler2D lava_glow_map;
+
+layout(set = 2, binding = 1) readonly buffer LightBuffer {
     PointLight point_lights[];
 };
 
+const vec3 LAVA_GLOW_COLOR = vec3(1.0, 0.35, 0.05);
+
 vec3 apply_point_light(PointLight light, vec3 frag_pos, vec3 normal, vec3 base_color) {
     vec3  to_light = light.positionRadius.xyz - frag_pos;
     float dist     = length(to_light);
@@ -34,6 +38,31 @@ vec3 apply_point_light(PointLight light, vec3 frag_pos, vec3 normal, vec3 base_c
     return base_color * light.colorIntensity.rgb * light.colorIntensity.w * atten * NdotL;
 }
 
+// Glow from the baked lava distance field (distance / GLOW_RADIUS). The light
+// direction is the field's downhill gradient, one unit up like the old
+// per-body lights, so slopes facing a lava shore catch the glow.
+vec3 apply_lava_glow(vec3 frag_pos, vec3 normal, vec3 base_color) {
+    // Texel centres sit on pixel centres.
+    vec2  texel = 1.0 / vec2(textureSize(lava_glow_map, 0));
+    vec2  uv    = frag_pos.xy * GLOW_SCALE + 0.5 * texel;
+    float t     = texture(lava_glow_map, uv).r;
+    if (t >= 1.0) return vec3(0.0);
+
+    vec2  grad  = vec2(texture(lava_glow_map, uv + vec2(texel.x, 0.0)).r -
+                       texture(lava_glow_map, uv - vec2(texel.x, 0.0)).r,
+                       texture(lava_glow_map, uv + vec2(0.0, texel.y)).r -
+                       texture(lava_glow_map, uv - vec2(0.0, texel.y)).r);
+    vec2  to_lava = length(grad) > 0.0 ? -normalize(grad) * t * GLOW_RADIUS : vec2(0.0);
+
+    float atten = 1.0 - t;
+    atten = atten * atten;
+
+    vec3  L     = normalize(vec3(to_lava, 1.0));
+    float NdotL = max(dot(normalize(normal), L), 0.0);
+
+    return base_color * LAVA_GLOW_COLOR * GLOW_INTENSITY * atten * NdotL;
+}
+
 vec3 apply_directional(vec3 color, vec3 normal) {
     float diffuse = max(dot(normalize(normal), light_dir.xyz), 0.0);
     return color * (light_dir.w + diffuse * light_col.rgb);
@@ -66,6 +95,7 @@ void main() {
     vec3  dithered = clamp(frag_color * (1.0 + dither), 0.0, 1.0);
 
     vec3 lit = apply_directional(dithered, frag_normal);
+    lit += apply_lava_glow(frag_world_pos, frag_normal, dithered);
 
     uint count = LIGHT_COUNT;
     for (uint i = 0; i < count && i < 128u; ++i) {
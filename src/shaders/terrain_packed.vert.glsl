@@ -0,0 +1,30 @@
+#version 450
+
+#include "coord.glsl"
+
+// PackedBasaltVertex: unorm16 position, RGBA8 colour with sheen in alpha,
+// octahedral snorm16 normal.
+layout(location = 0) in vec3 in_pos;
+layout(location = 1) in vec4 in_color;
+layout(location = 2) in vec2 in_normal;
+
+layout(location = 0) out vec3  frag_color;
+layout(location = 1) out vec3  frag_world_pos;
+layout(location = 2) out float frag_sheen;
+layout(location = 3) out vec3  frag_normal;
+
+vec3 oct_decode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main() {
+    vec3 pos = unpack_position(in_pos);
+    gl_Position    = projection * view * vec4(pos, 1.0);
+    frag_color     = in_color.rgb;
+    frag_world_pos = pos;
+    frag_sheen     = in_color.a;
+    frag_normal    = oct_decode(in_normal);
+}